@@ -0,0 +1,955 @@
+#include <AbyssFramework/Allocators.h>
+#include <AbyssFramework/Log.h>
+#include <AbyssFramework/Macros.h>
+#include <AbyssFramework/NumberFormat.h>
+#include <AbyssFramework/Profiler.h>
+#include <AbyssFramework/sinks/ConsoleSink.h>
+#include <AbyssFramework/containers/BiMap.hpp>
+#include <AbyssFramework/sinks/JsonSink.h>
+#include <AbyssFramework/containers/ConcurrentBiMap.hpp>
+#include <AbyssFramework/containers/FrozenBiMap.hpp>
+#include <AbyssFramework/containers/MappedBiMap.hpp>
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory_resource>
+#include <new>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Reproducible logger and container benchmarks.
+// Usage: AbyssFrameworkBenchSuite [--quick] [--filter <substr>] [--json <file>] [--csv <file>] [--bimap-max <n>]
+// A human readable table goes to stderr. The console scenarios write log lines to stdout,
+// run with stdout redirected (e.g. > /dev/null) to keep the terminal out of the numbers.
+
+namespace {
+
+    std::atomic<std::uint64_t> g_Allocations{ 0 };
+    std::atomic<std::int64_t>  g_LiveBytes{ 0 };
+
+    // Each block carries its requested size in front of it so delete can subtract it again.
+    constexpr std::size_t alloc_header = alignof(std::max_align_t);
+
+}
+
+// Every heap allocation in the process is counted, allocation scenarios run single threaded.
+#if defined(__GNUC__) && !defined(__clang__)
+#   pragma GCC diagnostic ignored "-Wmismatched-new-delete" // malloc/free pairs are the point of the replacement
+#endif
+void* operator new(std::size_t size) {
+    g_Allocations.fetch_add(1, std::memory_order_relaxed);
+    if (auto* p = static_cast<std::byte*>(std::malloc(size + alloc_header))) {
+        std::memcpy(p, &size, sizeof(size));
+        g_LiveBytes.fetch_add(static_cast<std::int64_t>(size), std::memory_order_relaxed);
+        return p + alloc_header;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    if (!p) {
+        return;
+    }
+    auto* block = static_cast<std::byte*>(p) - alloc_header;
+    std::size_t size;
+    std::memcpy(&size, block, sizeof(size));
+    g_LiveBytes.fetch_sub(static_cast<std::int64_t>(size), std::memory_order_relaxed);
+    std::free(block);
+}
+void operator delete[](void* p) noexcept { ::operator delete(p); }
+void operator delete(void* p, std::size_t) noexcept { ::operator delete(p); }
+void operator delete[](void* p, std::size_t) noexcept { ::operator delete(p); }
+
+// Over-aligned types (alignas(64) queue slots) come through here. The block is realigned inside a
+// larger malloc one, the size and malloc's pointer go in the header right before the returned address.
+static_assert(sizeof(std::size_t) + sizeof(void*) <= alloc_header);
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    g_Allocations.fetch_add(1, std::memory_order_relaxed);
+    auto align = std::max(static_cast<std::size_t>(alignment), alloc_header);
+    if (auto* raw = static_cast<std::byte*>(std::malloc(size + alloc_header + align))) {
+        auto addr = (reinterpret_cast<std::uintptr_t>(raw) + alloc_header + align - 1) / align * align;
+        auto* p   = raw + (addr - reinterpret_cast<std::uintptr_t>(raw));
+        std::memcpy(p - alloc_header, &size, sizeof(size));
+        std::memcpy(p - alloc_header + sizeof(size), &raw, sizeof(raw));
+        g_LiveBytes.fetch_add(static_cast<std::int64_t>(size), std::memory_order_relaxed);
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return ::operator new(size, alignment);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    if (!p) {
+        return;
+    }
+    auto* header = static_cast<std::byte*>(p) - alloc_header;
+    std::size_t size;
+    void*       raw;
+    std::memcpy(&size, header, sizeof(size));
+    std::memcpy(&raw, header + sizeof(size), sizeof(raw));
+    g_LiveBytes.fetch_sub(static_cast<std::int64_t>(size), std::memory_order_relaxed);
+    std::free(raw);
+}
+void operator delete[](void* p, std::align_val_t alignment) noexcept { ::operator delete(p, alignment); }
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept { ::operator delete(p, alignment); }
+void operator delete[](void* p, std::size_t, std::align_val_t alignment) noexcept { ::operator delete(p, alignment); }
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+    using aby::log::ELevel;
+    using aby::log::Logger;
+
+    struct Result {
+        std::string scenario;
+        std::string variant;
+        std::string metric;
+        double      value = 0.0;
+        std::string unit;
+    };
+
+    struct Options {
+        bool        quick     = false;
+        std::string filter;
+        std::string json_path;
+        std::string csv_path;
+        std::size_t bimap_max = 1'000'000; // Pass 10000000 for the full 1e3..1e7 range (needs a few GB).
+    };
+
+    class Suite {
+    public:
+        explicit Suite(const Options& options) : m_Options(options) {}
+
+        bool selected(std::string_view scenario) const {
+            return m_Options.filter.empty() || scenario.find(m_Options.filter) != std::string_view::npos;
+        }
+
+        void add(std::string scenario, std::string variant, std::string metric, double value, std::string unit) {
+            std::fprintf(stderr, "%-22s %-26s %-18s %14.2f %s\n", scenario.c_str(), variant.c_str(), metric.c_str(), value, unit.c_str());
+            m_Results.push_back({ std::move(scenario), std::move(variant), std::move(metric), value, std::move(unit) });
+        }
+
+        auto messages() const -> std::size_t { return m_Options.quick ? 20'000 : 200'000; }
+        auto options() const -> const Options& { return m_Options; }
+
+        void write_json(const std::string& path) const {
+            std::FILE* f = std::fopen(path.c_str(), "w");
+            if (!f) {
+                std::fprintf(stderr, "cannot write %s\n", path.c_str());
+                return;
+            }
+            std::fprintf(f, "{\n  \"suite\": \"AbyssFramework\",\n  \"quick\": %s,\n  \"threads\": %u,\n  \"results\": [\n",
+                m_Options.quick ? "true" : "false", std::thread::hardware_concurrency());
+            for (std::size_t i = 0; i < m_Results.size(); ++i) {
+                const auto& r = m_Results[i];
+                std::fprintf(f, "    { \"scenario\": \"%s\", \"variant\": \"%s\", \"metric\": \"%s\", \"value\": %.3f, \"unit\": \"%s\" }%s\n",
+                    r.scenario.c_str(), r.variant.c_str(), r.metric.c_str(), r.value, r.unit.c_str(), i + 1 < m_Results.size() ? "," : "");
+            }
+            std::fprintf(f, "  ]\n}\n");
+            std::fclose(f);
+        }
+
+        void write_csv(const std::string& path) const {
+            std::FILE* f = std::fopen(path.c_str(), "w");
+            if (!f) {
+                std::fprintf(stderr, "cannot write %s\n", path.c_str());
+                return;
+            }
+            std::fprintf(f, "scenario,variant,metric,value,unit\n");
+            for (const auto& r : m_Results) {
+                std::fprintf(f, "%s,%s,%s,%.3f,%s\n", r.scenario.c_str(), r.variant.c_str(), r.metric.c_str(), r.value, r.unit.c_str());
+            }
+            std::fclose(f);
+        }
+    private:
+        Options             m_Options;
+        std::vector<Result> m_Results;
+    };
+
+    auto bench_dir() -> aby::fs::path {
+        return aby::fs::temp_directory_path();
+    }
+
+    // Puts the global logger into a known state, each scenario then turns on what it measures.
+    void reset_logger() {
+        auto& logger = Logger::get();
+        logger.flush();
+        auto& cfg = logger.config();
+        cfg.set_level(ELevel::ALL).set_to_console(false).set_async(false).set_staging({});
+        cfg.log_files.clear();
+        cfg.callbacks.clear();
+        cfg.sinks.clear();
+        cfg.console->set_levels(aby::log::all_levels).set_formatter(nullptr);
+    }
+
+    auto per_second(std::size_t count, Clock::duration elapsed) -> double {
+        return static_cast<double>(count) / std::chrono::duration<double>(elapsed).count();
+    }
+
+    auto log_threads(std::size_t threads, std::size_t messages) -> double {
+        auto per_thread = messages / threads;
+        std::vector<std::thread> workers;
+        auto start = Clock::now();
+        for (std::size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([per_thread, t] {
+                for (std::size_t i = 0; i < per_thread; ++i) {
+                    log_info("Benchmark message {} from thread {} value {}", i, t, 3.25);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        Logger::get().flush();
+        return per_second(per_thread * threads, Clock::now() - start);
+    }
+
+    void throughput(Suite& suite) {
+        auto path = bench_dir() / "aby_suite_throughput.log";
+        for (bool async : { false, true }) {
+            for (std::size_t threads : { 1, 4 }) {
+                reset_logger();
+                aby::fs::remove(path);
+                Logger::get().config().add_file(path).set_async(async);
+                double rate = log_threads(threads, suite.messages());
+                suite.add("throughput", std::format("{}/{}t", async ? "async" : "sync", threads), "msgs", rate, "msg/s");
+            }
+        }
+        reset_logger();
+        aby::fs::remove(path);
+    }
+
+    void latency(Suite& suite) {
+        auto path = bench_dir() / "aby_suite_latency.log";
+        for (bool async : { false, true }) {
+            reset_logger();
+            aby::fs::remove(path);
+            Logger::get().config().add_file(path).set_async(async);
+
+            std::size_t calls = suite.messages();
+            std::vector<std::uint32_t> samples;
+            samples.reserve(calls);
+            for (std::size_t i = 0; i < calls; ++i) {
+                auto start = Clock::now();
+                log_info("Latency message {} value {}", i, 1.5);
+                samples.push_back(static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count()));
+            }
+            Logger::get().flush();
+
+            std::ranges::sort(samples);
+            auto at = [&](double q) { return static_cast<double>(samples[std::min(samples.size() - 1, static_cast<std::size_t>(q * samples.size()))]); };
+            auto variant = async ? "async/file" : "sync/file";
+            suite.add("latency", variant, "p50", at(0.50), "ns");
+            suite.add("latency", variant, "p99", at(0.99), "ns");
+            suite.add("latency", variant, "p999", at(0.999), "ns");
+        }
+        reset_logger();
+        aby::fs::remove(path);
+    }
+
+    template <typename F>
+    auto allocations_per_call(std::size_t calls, F&& fn) -> double {
+        auto before = g_Allocations.load(std::memory_order_relaxed);
+        for (std::size_t i = 0; i < calls; ++i) {
+            fn(i);
+        }
+        return static_cast<double>(g_Allocations.load(std::memory_order_relaxed) - before) / static_cast<double>(calls);
+    }
+
+    void allocations(Suite& suite) {
+        auto path = bench_dir() / "aby_suite_allocations.log";
+        reset_logger();
+        aby::fs::remove(path);
+        Logger::get().config().add_file(path);
+
+        std::size_t calls = suite.messages() / 10;
+        // Warm up lazily created state (file sink, timestamp caches) so it is not charged to the calls.
+        log_info("warm up {}", 0);
+        Logger::get().write(ELevel::INFO, "warm up");
+
+        suite.add("allocations", "log_info/deferred", "per_call",
+            allocations_per_call(calls, [](std::size_t i) { log_info("Message {} {}", i, "text"); }), "allocs");
+        suite.add("allocations", "log_info/formatted", "per_call",
+            allocations_per_call(calls, [](std::size_t i) { log_info("Message {} {}", i, static_cast<long double>(i)); }), "allocs");
+        std::string text = "A preformatted message that does not fit the small string buffer";
+        suite.add("allocations", "Logger::write", "per_call",
+            allocations_per_call(calls, [&](std::size_t) { Logger::get().write(ELevel::INFO, text); }), "allocs");
+        suite.add("allocations", "current_time", "per_call",
+            allocations_per_call(calls, [](std::size_t) { (void)aby::log::current_time(); }), "allocs");
+        suite.add("allocations", "format_with_commas", "per_call",
+            allocations_per_call(calls, [](std::size_t i) { (void)aby::log::format_with_commas(static_cast<std::int64_t>(i) * 1'000'003); }), "allocs");
+
+        // Structured record into the JSON sink alone, nothing renders the text line.
+        auto json_path = bench_dir() / "aby_suite_allocations.jsonl";
+        reset_logger();
+        aby::fs::remove(json_path);
+        Logger::get().config().add_sink(aby::create_ref<aby::log::JsonSink>(json_path));
+        std::string user = "bench-user";
+        log_info_kv(({ "user", user }, { "id", 0 }), "warm up {}", 0);
+        suite.add("allocations", "log_info_kv/json", "per_call",
+            allocations_per_call(calls, [&](std::size_t i) { log_info_kv(({ "user", user }, { "id", i }, { "ratio", 0.5 }), "Message {} {}", i, "text"); }), "allocs");
+
+        reset_logger();
+        aby::fs::remove(path);
+        aby::fs::remove(json_path);
+    }
+
+    void outputs(Suite& suite) {
+        auto path = bench_dir() / "aby_suite_outputs.log";
+        auto run = [&](std::string_view variant, auto&& configure) {
+            reset_logger();
+            aby::fs::remove(path);
+            configure(Logger::get().config());
+            auto calls = suite.messages();
+            auto start = Clock::now();
+            for (std::size_t i = 0; i < calls; ++i) {
+                log_info("Output message {} value {}", i, 2.5);
+            }
+            Logger::get().flush();
+            auto elapsed = Clock::now() - start;
+            suite.add("outputs", std::string(variant), "per_call",
+                std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(calls), "ns");
+        };
+
+        using aby::log::Config;
+        using aby::log::Message;
+        auto noop = [](const Message&) -> std::optional<std::string> { return std::nullopt; };
+        run("level filtered", [](Config& cfg) { cfg.set_level(ELevel::NONE); });
+        run("no outputs",     [](Config&) {});
+        run("file",           [&](Config& cfg) { cfg.add_file(path); });
+        run("console",        [](Config& cfg) { cfg.set_to_console(true); });
+        run("callback inline", [&](Config& cfg) { cfg.add_callback(noop); });
+        run("callback worker", [&](Config& cfg) {
+            cfg.subscribe(aby::log::Subscription(noop).set_mode(aby::log::ECallbackMode::WORKER).set_overflow_policy(aby::log::EOverflowPolicy::BLOCK));
+        });
+        run("file+console+callback", [&](Config& cfg) { cfg.add_file(path).set_to_console(true).add_callback(noop); });
+        // Same outputs, but the console only takes errors: the INFO lines are never formatted for it.
+        run("file+console(err)+callback", [&](Config& cfg) {
+            cfg.add_file(path).set_to_console(true).add_callback(noop);
+            cfg.console->set_levels(aby::log::level_mask({ ELevel::ERROR }));
+        });
+        // Two files in the default layout share one rendering.
+        run("2 files", [&](Config& cfg) { cfg.add_file(path).add_file(bench_dir() / "aby_suite_outputs_2.log"); });
+        run("json",           [&](Config& cfg) { cfg.add_sink(aby::create_ref<aby::log::JsonSink>(path)); });
+
+        reset_logger();
+        aby::fs::remove(path);
+        aby::fs::remove(bench_dir() / "aby_suite_outputs_2.log");
+    }
+
+    // format_with_commas before the NumberFormat kernels, kept as the baseline.
+    auto legacy_commas(std::int64_t value) -> std::string {
+        std::string num = std::to_string(value);
+        std::int64_t insert_position = static_cast<std::int64_t>(num.length()) - 3;
+        while (insert_position > 0) {
+            num.insert(static_cast<std::size_t>(insert_position), ",");
+            insert_position -= 3;
+        }
+        return num;
+    }
+
+    // Integer kernels against std::format / std::to_chars, and argument rendering with and without them.
+    // Values alternate in sign and span 1 to 13 digits. Each variant writes into a reused buffer.
+    template <typename TimePerCall>
+    void numbers(Suite& suite, TimePerCall&& time_per_call) {
+        auto value = [](std::size_t i) -> std::int64_t {
+            auto v = static_cast<std::int64_t>(i) * 1'000'003;
+            return (i & 1) ? -v : v;
+        };
+        std::string out;
+        char        buffer[aby::log::max_unit_chars];
+        std::size_t checksum = 0;
+
+        suite.add("formatting", "integer/std::format", "per_call", time_per_call([&](std::size_t i) {
+            out.clear();
+            std::format_to(std::back_inserter(out), "{}", value(i));
+            checksum += out.size();
+        }), "ns");
+        suite.add("formatting", "integer/to_chars", "per_call", time_per_call([&](std::size_t i) {
+            checksum += static_cast<std::size_t>(std::to_chars(buffer, buffer + sizeof(buffer), value(i)).ptr - buffer);
+        }), "ns");
+        suite.add("formatting", "integer/format_decimal", "per_call", time_per_call([&](std::size_t i) {
+            checksum += static_cast<std::size_t>(aby::log::format_decimal(buffer, value(i)) - buffer);
+        }), "ns");
+        suite.add("formatting", "grouped/legacy", "per_call", time_per_call([&](std::size_t i) {
+            checksum += legacy_commas(value(i)).size();
+        }), "ns");
+        suite.add("formatting", "grouped/format_grouped", "per_call", time_per_call([&](std::size_t i) {
+            checksum += static_cast<std::size_t>(aby::log::format_grouped(buffer, value(i)) - buffer);
+        }), "ns");
+        suite.add("formatting", "bytes/format_bytes", "per_call", time_per_call([&](std::size_t i) {
+            checksum += static_cast<std::size_t>(aby::log::format_bytes(buffer, static_cast<std::uint64_t>(i) * 7'919'993) - buffer);
+        }), "ns");
+        suite.add("formatting", "duration/format_duration", "per_call", time_per_call([&](std::size_t i) {
+            checksum += static_cast<std::size_t>(aby::log::format_duration(buffer, std::chrono::nanoseconds(value(i))) - buffer);
+        }), "ns");
+
+        // What a deferred "{} {} {}" record costs to render on the backend, the typed path against plain vformat.
+        constexpr std::string_view fmt = "Request {} took {} us for {}";
+        aby::log::ArgBuffer args;
+        std::string_view    user = "bob";
+        suite.add("formatting", "render_args/integers", "per_call", time_per_call([&](std::size_t i) {
+            (void)args.encode(static_cast<std::uint64_t>(i), value(i), user);
+            out.clear();
+            aby::log::render_args<std::uint64_t, std::int64_t, std::string_view>(out, fmt, args);
+            checksum += out.size();
+        }), "ns");
+        suite.add("formatting", "render_args/vformat", "per_call", time_per_call([&](std::size_t i) {
+            (void)args.encode(static_cast<std::uint64_t>(i), value(i), user);
+            aby::log::ArgReader reader(args);
+            auto id      = reader.read<std::uint64_t>();
+            auto elapsed = reader.read<std::int64_t>();
+            auto name    = reader.read<std::string_view>();
+            out.clear();
+            std::vformat_to(std::back_inserter(out), fmt, std::make_format_args(id, elapsed, name));
+            checksum += out.size();
+        }), "ns");
+
+        if (checksum == 0) {
+            std::fprintf(stderr, "numbers: nothing was formatted\n");
+        }
+    }
+
+    void formatting(Suite& suite) {
+        std::size_t calls = suite.messages();
+        auto time_per_call = [&](auto&& fn) {
+            auto start = Clock::now();
+            for (std::size_t i = 0; i < calls; ++i) {
+                fn(i);
+            }
+            return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(calls);
+        };
+
+        const auto& cfg = Logger::get().config();
+        std::string line;
+        suite.add("formatting", "format_line", "per_call", time_per_call([&](std::size_t) {
+            line.clear();
+            aby::log::format_line(line, cfg, ELevel::WARN, "15-Oct-2026 13:37:00", "A message of typical length for a log line");
+        }), "ns");
+        suite.add("formatting", "current_time", "per_call", time_per_call([](std::size_t) { (void)aby::log::current_time(); }), "ns");
+        suite.add("formatting", "format_with_commas", "per_call", time_per_call([](std::size_t i) {
+            (void)aby::log::format_with_commas(static_cast<std::int64_t>(i) * 1'000'003);
+        }), "ns");
+        numbers(suite, time_per_call);
+    }
+
+    // What the logger's own metrics report under a contended file workload, and what a snapshot costs.
+    void metrics(Suite& suite) {
+        auto path = bench_dir() / "aby_suite_metrics.log";
+        reset_logger();
+        aby::fs::remove(path);
+        auto& logger = Logger::get();
+        logger.config().add_file(path);
+
+        auto before = logger.metrics();
+        (void)log_threads(4, suite.messages());
+        auto delta = logger.metrics().since(before);
+        suite.add("metrics", "sync/4t", "lock_contended",
+            100.0 * static_cast<double>(delta.lock_contended) / static_cast<double>(std::max<std::uint64_t>(delta.lock_acquisitions, 1)), "%");
+        suite.add("metrics", "sync/4t", "lock_wait_p50", static_cast<double>(delta.lock_wait.percentile_ns(0.50)), "ns");
+        suite.add("metrics", "sync/4t", "lock_wait_p99", static_cast<double>(delta.lock_wait.percentile_ns(0.99)), "ns");
+
+        std::size_t calls = 1000;
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < calls; ++i) {
+            (void)logger.metrics();
+        }
+        suite.add("metrics", "snapshot", "per_call", std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(calls), "ns");
+
+        reset_logger();
+        aby::fs::remove(path);
+    }
+
+    // Four threads logging to files, all through the default logger or each through a named logger of its own.
+    void loggers(Suite& suite) {
+        constexpr std::size_t threads = 4;
+        auto log_path = [](std::size_t i) { return bench_dir() / std::format("aby_suite_loggers_{}.log", i); };
+        auto run = [&](std::string_view variant, auto&& logger_of) {
+            std::vector<Logger*> targets;  // Per thread.
+            std::vector<Logger*> distinct; // Each with a file of its own.
+            for (std::size_t t = 0; t < threads; ++t) {
+                auto& logger = logger_of(t);
+                targets.push_back(&logger);
+                if (std::ranges::find(distinct, &logger) == distinct.end()) {
+                    aby::fs::remove(log_path(distinct.size()));
+                    logger.config().set_level(ELevel::ALL).set_to_console(false).set_async(false).set_staging({}).add_file(log_path(distinct.size()));
+                    distinct.push_back(&logger);
+                }
+            }
+
+            std::vector<aby::log::MetricsSnapshot> before;
+            for (auto* logger : distinct) {
+                before.push_back(logger->metrics());
+            }
+            auto per_thread = suite.messages() / threads;
+            std::vector<std::thread> workers;
+            auto start = Clock::now();
+            for (std::size_t t = 0; t < threads; ++t) {
+                workers.emplace_back([&logger = *targets[t], per_thread, t] {
+                    for (std::size_t i = 0; i < per_thread; ++i) {
+                        log_info_to(logger, "Benchmark message {} from thread {} value {}", i, t, 3.25);
+                    }
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            for (auto* logger : distinct) {
+                logger->flush();
+            }
+            auto elapsed = Clock::now() - start;
+
+            std::uint64_t acquisitions = 0;
+            std::uint64_t contended    = 0;
+            for (std::size_t i = 0; i < distinct.size(); ++i) {
+                auto delta = distinct[i]->metrics().since(before[i]);
+                acquisitions += delta.lock_acquisitions;
+                contended    += delta.lock_contended;
+                distinct[i]->config().log_files.clear();
+                aby::fs::remove(log_path(i));
+            }
+            suite.add("loggers", std::string(variant), "msgs", per_second(per_thread * threads, elapsed), "msg/s");
+            suite.add("loggers", std::string(variant), "lock_contended",
+                100.0 * static_cast<double>(contended) / static_cast<double>(std::max<std::uint64_t>(acquisitions, 1)), "%");
+        };
+
+        reset_logger();
+        run("shared/4t",     [](std::size_t) -> Logger& { return Logger::get(); });
+        run("per_thread/4t", [](std::size_t t) -> Logger& { return Logger::get(std::format("bench.{}", t)); });
+        reset_logger();
+    }
+
+    // Cost of one profiling zone, timed with prof::Scope directly so it runs whether or not
+    // ABY_PROFILE_SCOPE is compiled in, and of turning the recorded zones into a trace.
+    void profiling(Suite& suite) {
+        static constexpr aby::prof::Zone zone{ "bench.zone", "BenchSuite.cpp", "profiling", __LINE__ };
+        std::size_t zones = suite.messages();
+        (void)aby::prof::capture(); // Start from empty buffers.
+
+        auto run = [&](std::size_t threads) {
+            auto per_thread = zones / threads;
+            std::vector<std::thread> workers;
+            auto start = Clock::now();
+            for (std::size_t t = 0; t < threads; ++t) {
+                workers.emplace_back([per_thread] {
+                    for (std::size_t i = 0; i < per_thread; ++i) {
+                        aby::prof::Scope scope(zone);
+                    }
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(per_thread);
+        };
+        suite.add("profiling", "zone t=1", "per_zone", run(1), "ns");
+        suite.add("profiling", "zone t=4", "per_zone", run(4), "ns");
+
+        auto start = Clock::now();
+        auto capture = aby::prof::capture();
+        std::size_t events = 0;
+        for (const auto& thread : capture.threads) {
+            events += thread.events.size();
+        }
+        suite.add("profiling", "capture", "per_zone", std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(events), "ns");
+
+        start = Clock::now();
+        auto json = aby::prof::to_chrome_trace(capture);
+        suite.add("profiling", "chrome_trace", "per_zone", std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(events), "ns");
+        suite.add("profiling", "chrome_trace", "size", static_cast<double>(json.size()) / static_cast<double>(events), "bytes/zone");
+
+        auto path = bench_dir() / "aby_suite.abyprof";
+        start = Clock::now();
+        bool written = aby::prof::write_binary(capture, path);
+        suite.add("profiling", "binary", "per_zone", std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(events), "ns");
+        suite.add("profiling", "binary", "size", static_cast<double>(written ? aby::fs::file_size(path) : 0) / static_cast<double>(events), "bytes/zone");
+        aby::fs::remove(path);
+
+        if (!written || events != zones / 4 * 4 + zones) {
+            std::fprintf(stderr, "profiling: unexpected state (%zu zones captured)\n", events);
+        }
+    }
+
+    // Same workload for every storage policy, memory is the heap held by the map after the inserts.
+    template <typename Policy>
+    void bimap_policy(Suite& suite, std::string_view policy) {
+        std::size_t max = suite.options().quick ? std::min<std::size_t>(suite.options().bimap_max, 100'000) : suite.options().bimap_max;
+        for (std::size_t n = 1'000; n <= max; n *= 10) {
+            // Shuffled keys so the tree sees the access pattern of real lookups, fixed seed for reproducibility.
+            std::vector<std::uint64_t> keys(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                keys[i] = i * 2654435761u;
+            }
+            std::mt19937_64 rng(42);
+            std::ranges::shuffle(keys, rng);
+
+            aby::containers::BiMap<std::uint64_t, std::string, Policy> map;
+            auto variant = std::format("{} n={}", policy, n);
+            auto per_op = [&](Clock::time_point start) {
+                return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(n);
+            };
+
+            std::vector<std::string> values(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                values[i] = std::format("value-{}", keys[i]);
+            }
+
+            auto live = g_LiveBytes.load(std::memory_order_relaxed);
+            auto start = Clock::now();
+            for (std::size_t i = 0; i < n; ++i) {
+                map.insert(keys[i], values[i]);
+            }
+            suite.add("bimap", variant, "insert", per_op(start), "ns/op");
+            auto held = g_LiveBytes.load(std::memory_order_relaxed) - live;
+            suite.add("bimap", variant, "memory", static_cast<double>(held) / static_cast<double>(n), "bytes/entry");
+
+            std::ranges::shuffle(keys, rng);
+            std::size_t found = 0;
+            start = Clock::now();
+            for (std::size_t i = 0; i < n; ++i) {
+                found += map.contains(keys[i]);
+            }
+            suite.add("bimap", variant, "lookup_left", per_op(start), "ns/op");
+
+            start = Clock::now();
+            for (std::size_t i = 0; i < n; ++i) {
+                found += map.contains(values[i]);
+            }
+            suite.add("bimap", variant, "lookup_right", per_op(start), "ns/op");
+
+            // Name -> id through a string_view, the transparent indexes look it up without a std::string.
+            std::size_t found_views = 0;
+            start = Clock::now();
+            for (std::size_t i = 0; i < n; ++i) {
+                found_views += map.right().contains(std::string_view(values[i]));
+            }
+            suite.add("bimap", variant, "lookup_right_view", per_op(start), "ns/op");
+
+            start = Clock::now();
+            for (std::size_t i = 0; i < n; ++i) {
+                map.erase(keys[i]);
+            }
+            suite.add("bimap", variant, "erase", per_op(start), "ns/op");
+
+            if (found != 2 * n || found_views != n || !map.empty()) {
+                std::fprintf(stderr, "bimap: unexpected state (found %zu of %zu)\n", found + found_views, 3 * n);
+            }
+        }
+    }
+
+    // Read-only tables: a bulk built FrozenBiMap, compare "build" with the per-pair "insert" of the
+    // policies above, and the same pairs as a MappedBiMap snapshot.
+    void bimap_frozen(Suite& suite) {
+        std::size_t max = suite.options().quick ? std::min<std::size_t>(suite.options().bimap_max, 100'000) : suite.options().bimap_max;
+        for (std::size_t n = 1'000; n <= max; n *= 10) {
+            std::vector<std::uint64_t> keys(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                keys[i] = i * 2654435761u;
+            }
+            std::mt19937_64 rng(42);
+            std::ranges::shuffle(keys, rng);
+
+            std::vector<std::pair<std::uint64_t, std::string>> pairs(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                pairs[i] = { keys[i], std::format("value-{}", keys[i]) };
+            }
+            auto variant = std::format("frozen n={}", n);
+            auto per_op = [&](Clock::time_point start) {
+                return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(n);
+            };
+
+            auto live = g_LiveBytes.load(std::memory_order_relaxed);
+            auto start = Clock::now();
+            auto map = aby::containers::freeze<std::uint64_t, std::string>(pairs);
+            suite.add("bimap", variant, "build", per_op(start), "ns/op");
+            auto held = g_LiveBytes.load(std::memory_order_relaxed) - live;
+            suite.add("bimap", variant, "memory", static_cast<double>(held) / static_cast<double>(n), "bytes/entry");
+
+            std::ranges::shuffle(keys, rng);
+            std::size_t found = 0;
+            start = Clock::now();
+            for (std::size_t i = 0; i < n; ++i) {
+                found += map.contains(keys[i]);
+            }
+            suite.add("bimap", variant, "lookup_left", per_op(start), "ns/op");
+
+            start = Clock::now();
+            for (std::size_t i = 0; i < n; ++i) {
+                found += map.contains(pairs[i].second);
+            }
+            suite.add("bimap", variant, "lookup_right", per_op(start), "ns/op");
+
+            start = Clock::now();
+            for (std::size_t i = 0; i < n; ++i) {
+                found += map.right().contains(std::string_view(pairs[i].second));
+            }
+            suite.add("bimap", variant, "lookup_right_view", per_op(start), "ns/op");
+
+            // The same table as a snapshot file: heap use after open() is what each extra process pays.
+            using Mapped = aby::containers::MappedBiMap<std::uint64_t, std::string>;
+            auto path = bench_dir() / "abyss_bench.bimap";
+            variant = std::format("mapped n={}", n);
+            start = Clock::now();
+            bool saved = Mapped::save(path, map);
+            suite.add("bimap", variant, "save", per_op(start), "ns/op");
+
+            Mapped mapped;
+            live = g_LiveBytes.load(std::memory_order_relaxed);
+            start = Clock::now();
+            bool opened = saved && mapped.open(path);
+            suite.add("bimap", variant, "open", std::chrono::duration<double, std::micro>(Clock::now() - start).count(), "us");
+            held = g_LiveBytes.load(std::memory_order_relaxed) - live;
+            suite.add("bimap", variant, "memory", static_cast<double>(held) / static_cast<double>(n), "bytes/entry");
+
+            start = Clock::now();
+            for (std::size_t i = 0; i < n; ++i) {
+                found += mapped.contains(keys[i]);
+            }
+            suite.add("bimap", variant, "lookup_left", per_op(start), "ns/op");
+
+            start = Clock::now();
+            for (std::size_t i = 0; i < n; ++i) {
+                found += mapped.contains(pairs[i].second);
+            }
+            suite.add("bimap", variant, "lookup_right", per_op(start), "ns/op");
+            mapped.close();
+            aby::fs::remove(path);
+
+            if (!opened || found != 5 * n) {
+                std::fprintf(stderr, "bimap: unexpected state (found %zu of %zu)\n", found, 5 * n);
+            }
+        }
+    }
+
+    // Ordered BiMap on the heap, a NodePool and an Arena. "teardown" is the whole map going away:
+    // a free per node on the heap, a free-list push per node plus one free per chunk in the pool,
+    // a single reset() in the arena (the map is never destroyed).
+    void bimap_resources(Suite& suite) {
+        using Map = aby::containers::pmr::BiMap<std::uint64_t, std::pmr::string>;
+        std::size_t max = suite.options().quick ? std::min<std::size_t>(suite.options().bimap_max, 100'000) : suite.options().bimap_max;
+        for (std::size_t n = 1'000; n <= max; n *= 10) {
+            std::vector<std::uint64_t> keys(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                keys[i] = i * 2654435761u;
+            }
+            std::mt19937_64 rng(42);
+            std::ranges::shuffle(keys, rng);
+
+            std::vector<std::string> values(n);
+            for (std::size_t i = 0; i < n; ++i) {
+                values[i] = std::format("value-{}", keys[i]);
+            }
+            auto per_op = [&](Clock::time_point start) {
+                return std::chrono::duration<double, std::nano>(Clock::now() - start).count() / static_cast<double>(n);
+            };
+            auto fill = [&](Map& map) {
+                for (std::size_t i = 0; i < n; ++i) {
+                    map.insert(keys[i], std::pmr::string(values[i], map.get_allocator()));
+                }
+            };
+            auto us_since = [](Clock::time_point start) {
+                return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+            };
+            std::size_t found = 0;
+
+            {
+                auto variant = std::format("heap n={}", n);
+                auto* map = new Map(std::pmr::new_delete_resource());
+                auto start = Clock::now();
+                fill(*map);
+                suite.add("bimap_alloc", variant, "insert", per_op(start), "ns/op");
+                found += map->size();
+                start = Clock::now();
+                delete map;
+                suite.add("bimap_alloc", variant, "teardown", us_since(start), "us");
+            }
+            {
+                auto variant = std::format("node_pool n={}", n);
+                aby::NodePool pool;
+                auto* map = new Map(&pool);
+                auto start = Clock::now();
+                fill(*map);
+                suite.add("bimap_alloc", variant, "insert", per_op(start), "ns/op");
+                found += map->size();
+                start = Clock::now();
+                delete map;
+                pool.release();
+                suite.add("bimap_alloc", variant, "teardown", us_since(start), "us");
+            }
+            {
+                auto variant = std::format("arena n={}", n);
+                aby::Arena arena(1024 * 1024);
+                auto* map = arena.make<Map>(&arena);
+                auto start = Clock::now();
+                fill(*map);
+                suite.add("bimap_alloc", variant, "insert", per_op(start), "ns/op");
+                found += map->size();
+                start = Clock::now();
+                arena.reset();
+                suite.add("bimap_alloc", variant, "teardown", us_since(start), "us");
+            }
+
+            if (found != 3 * n) {
+                std::fprintf(stderr, "bimap_alloc: unexpected state (found %zu of %zu)\n", found, 3 * n);
+            }
+        }
+    }
+
+    void bimap(Suite& suite) {
+        bimap_policy<aby::containers::OrderedPolicy>(suite, "ordered");
+        bimap_policy<aby::containers::FlatHashPolicy>(suite, "flat_hash");
+        bimap_frozen(suite);
+    }
+
+    // The usual way to share a BiMap before ConcurrentBiMap, the baseline for bimap_scaling.
+    class SharedMutexBiMap {
+    public:
+        bool contains(std::uint64_t key) const {
+            std::shared_lock lock(m_Mutex);
+            return m_Map.contains(key);
+        }
+        bool insert(std::uint64_t key, const std::string& value) {
+            std::unique_lock lock(m_Mutex);
+            return m_Map.insert(key, value);
+        }
+        bool erase(std::uint64_t key) {
+            std::unique_lock lock(m_Mutex);
+            return m_Map.erase(key);
+        }
+    private:
+        mutable std::shared_mutex                                                      m_Mutex;
+        aby::containers::BiMap<std::uint64_t, std::string, aby::containers::FlatHashPolicy> m_Map;
+    };
+
+    // Readers hammer lookups while one writer inserts and erases a pair every 50us.
+    template <typename Map>
+    void bimap_scaling_run(Suite& suite, std::string_view name) {
+        constexpr std::size_t entries = 100'000;
+        auto duration = suite.options().quick ? std::chrono::milliseconds(50) : std::chrono::milliseconds(300);
+
+        for (std::size_t readers = 1; readers <= 64; readers *= 2) {
+            auto map = std::make_unique<Map>();
+            for (std::uint64_t i = 0; i < entries; ++i) {
+                map->insert(i, std::format("symbol-{}", i));
+            }
+
+            std::atomic<bool>          start{ false };
+            std::atomic<bool>          stop{ false };
+            std::atomic<std::uint64_t> reads{ 0 };
+            std::atomic<std::uint64_t> hits{ 0 };
+            std::atomic<std::uint64_t> writes{ 0 };
+            std::vector<std::thread>   threads;
+            for (std::size_t t = 0; t < readers; ++t) {
+                threads.emplace_back([&, t] {
+                    std::uint64_t key = t * 7919, local = 0, found = 0;
+                    while (!start.load(std::memory_order_acquire)) {
+                        std::this_thread::yield();
+                    }
+                    while (!stop.load(std::memory_order_relaxed)) {
+                        for (int i = 0; i < 256; ++i) {
+                            key = (key * 6364136223846793005ULL + 1442695040888963407ULL);
+                            found += map->contains((key >> 33) % entries);
+                        }
+                        local += 256;
+                    }
+                    reads.fetch_add(local, std::memory_order_relaxed);
+                    hits.fetch_add(found, std::memory_order_relaxed);
+                });
+            }
+            threads.emplace_back([&] {
+                while (!start.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+                for (std::uint64_t i = entries; !stop.load(std::memory_order_relaxed); ++i) {
+                    map->insert(i, "transient");
+                    map->erase(i);
+                    writes.fetch_add(2, std::memory_order_relaxed);
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+            });
+
+            auto begin = Clock::now();
+            start.store(true, std::memory_order_release);
+            std::this_thread::sleep_for(duration);
+            stop.store(true);
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            double seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+            if (hits.load() != reads.load()) {
+                std::fprintf(stderr, "bimap_scaling: %llu of %llu lookups missed a permanent key\n",
+                    static_cast<unsigned long long>(reads.load() - hits.load()), static_cast<unsigned long long>(reads.load()));
+            }
+            auto variant = std::format("{} readers={}", name, readers);
+            suite.add("bimap_scaling", variant, "reads", static_cast<double>(reads.load()) / seconds / 1e6, "Mops/s");
+            suite.add("bimap_scaling", variant, "reads_per_reader", static_cast<double>(reads.load()) / seconds / 1e6 / static_cast<double>(readers), "Mops/s");
+            suite.add("bimap_scaling", variant, "writes", static_cast<double>(writes.load()) / seconds, "ops/s");
+        }
+    }
+
+    void bimap_scaling(Suite& suite) {
+        bimap_scaling_run<aby::containers::ConcurrentBiMap<std::uint64_t, std::string>>(suite, "left_right");
+        bimap_scaling_run<SharedMutexBiMap>(suite, "shared_mutex");
+    }
+
+    auto parse(int argc, char** argv) -> Options {
+        Options options;
+        for (int i = 1; i < argc; ++i) {
+            std::string_view arg = argv[i];
+            auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : ""; };
+            if (arg == "--quick")          options.quick     = true;
+            else if (arg == "--filter")    options.filter    = value();
+            else if (arg == "--json")      options.json_path = value();
+            else if (arg == "--csv")       options.csv_path  = value();
+            else if (arg == "--bimap-max") options.bimap_max = std::strtoull(value(), nullptr, 10);
+            else {
+                std::fprintf(stderr, "usage: AbyssFrameworkBenchSuite [--quick] [--filter <substr>] [--json <file>] [--csv <file>] [--bimap-max <n>]\n");
+                std::exit(1);
+            }
+        }
+        return options;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    Suite suite(parse(argc, argv));
+
+    std::fprintf(stderr, "%-22s %-26s %-18s %14s\n", "scenario", "variant", "metric", "value");
+    if (suite.selected("throughput"))  throughput(suite);
+    if (suite.selected("latency"))     latency(suite);
+    if (suite.selected("allocations")) allocations(suite);
+    if (suite.selected("outputs"))     outputs(suite);
+    if (suite.selected("formatting"))  formatting(suite);
+    if (suite.selected("metrics"))     metrics(suite);
+    if (suite.selected("loggers"))     loggers(suite);
+    if (suite.selected("profiling"))   profiling(suite);
+    if (suite.selected("bimap"))       bimap(suite);
+    if (suite.selected("bimap_scaling")) bimap_scaling(suite);
+    if (suite.selected("bimap_alloc"))   bimap_resources(suite);
+
+    if (!suite.options().json_path.empty()) {
+        suite.write_json(suite.options().json_path);
+    }
+    if (!suite.options().csv_path.empty()) {
+        suite.write_csv(suite.options().csv_path);
+    }
+}
@@ -0,0 +1,65 @@
+#include <AbyssFramework/Log.h>
+#include <AbyssFramework/Macros.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+// Compares the old per-message open/append/close file path against the buffered FileSink.
+// Usage: AbyssFrameworkBench [messages]
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    auto rate(std::size_t messages, Clock::duration elapsed) -> double {
+        return static_cast<double>(messages) / std::chrono::duration<double>(elapsed).count();
+    }
+
+    // What Logger::write_files did per message before file sinks stayed open.
+    auto bench_reopen(const aby::fs::path& path, std::size_t messages) -> double {
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < messages; ++i) {
+            auto line = std::format("[{}] [{}{}{}] {}\n", aby::log::current_time(), COLOR_GREEN, "INFO", COLOR_RESET,
+                std::format("Benchmark message {} with some payload", i));
+            std::ofstream ofs(path, std::ios::app);
+            if (ofs.is_open()) {
+                ofs << line;
+                ofs.flush();
+            }
+        }
+        return rate(messages, Clock::now() - start);
+    }
+
+    auto bench_logger(const aby::fs::path& path, std::size_t messages) -> double {
+        auto& logger = aby::log::Logger::get();
+        logger.config().set_to_console(false).add_file(path);
+        auto start = Clock::now();
+        for (std::size_t i = 0; i < messages; ++i) {
+            log_info("Benchmark message {} with some payload", i);
+        }
+        logger.flush();
+        return rate(messages, Clock::now() - start);
+    }
+
+}
+
+int main(int argc, char** argv) {
+    std::size_t messages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+    auto dir = aby::fs::temp_directory_path();
+    auto reopen_path   = dir / "aby_bench_reopen.log";
+    auto buffered_path = dir / "aby_bench_buffered.log";
+    aby::fs::remove(reopen_path);
+    aby::fs::remove(buffered_path);
+
+    double before = bench_reopen(reopen_path, messages);
+    double after  = bench_logger(buffered_path, messages);
+
+    std::printf("%-24s %14s\n", "file sink", "msgs/sec");
+    std::printf("%-24s %14s\n", "reopen per message", aby::log::format_with_commas(static_cast<int64_t>(before)).c_str());
+    std::printf("%-24s %14s\n", "buffered FileSink", aby::log::format_with_commas(static_cast<int64_t>(after)).c_str());
+    std::printf("%-24s %13.1fx\n", "speedup", after / before);
+
+    aby::fs::remove(reopen_path);
+    aby::fs::remove(buffered_path);
+}
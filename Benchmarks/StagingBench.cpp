@@ -0,0 +1,62 @@
+#include <AbyssFramework/Log.h>
+#include <AbyssFramework/Macros.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+// Compares the single-lock sync path against per-thread staging at 1, 4, 16 and 64 threads.
+// Usage: AbyssFrameworkStagingBench [messages per run]
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    auto run(std::size_t threads, std::size_t messages) -> double {
+        auto per_thread = messages / threads;
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        auto start = Clock::now();
+        for (std::size_t t = 0; t < threads; ++t) {
+            workers.emplace_back([t, per_thread] {
+                for (std::size_t i = 0; i < per_thread; ++i) {
+                    log_info("Benchmark message {} from thread {} with some payload", i, t);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        aby::log::Logger::get().flush();
+        auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        return static_cast<double>(per_thread * threads) / seconds;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    std::size_t messages = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 400'000;
+    auto path = aby::fs::temp_directory_path() / "aby_bench_staging.log";
+
+    auto& cfg = aby::log::Logger::get().config();
+    cfg.set_to_console(false);
+    cfg.log_files = { path };
+
+    std::printf("%-8s %16s %16s %9s\n", "threads", "single lock/s", "staged/s", "speedup");
+    for (std::size_t threads : { 1, 4, 16, 64 }) {
+        aby::fs::remove(path);
+        cfg.set_staging({ .enabled = false });
+        double locked = run(threads, messages);
+
+        aby::fs::remove(path);
+        cfg.set_staging({ .enabled = true });
+        double staged = run(threads, messages);
+
+        std::printf("%-8zu %16s %16s %8.1fx\n", threads,
+            aby::log::format_with_commas(static_cast<int64_t>(locked)).c_str(),
+            aby::log::format_with_commas(static_cast<int64_t>(staged)).c_str(),
+            staged / locked);
+    }
+    aby::fs::remove(path);
+}
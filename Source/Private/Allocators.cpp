@@ -0,0 +1,144 @@
+#include "Allocators.h"
+#include <algorithm>
+
+namespace aby {
+
+    namespace {
+        // Bytes to skip from p to the next multiple of alignment.
+        auto padding(const std::byte* p, std::size_t alignment) -> std::size_t {
+            auto addr = reinterpret_cast<std::uintptr_t>(p);
+            return (alignment - addr % alignment) % alignment;
+        }
+
+        auto round_up(std::size_t size, std::size_t alignment) -> std::size_t {
+            return (size + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    // Header at the start of every chunk, the usable bytes follow it.
+    struct Arena::Chunk {
+        Chunk*      next;
+        std::size_t size; // Including this header.
+
+        auto begin() -> std::byte* { return reinterpret_cast<std::byte*>(this) + sizeof(Chunk); }
+        auto end() -> std::byte* { return reinterpret_cast<std::byte*>(this) + size; }
+    };
+
+    Arena::Arena(std::size_t chunk_size, std::pmr::memory_resource* upstream) :
+        m_Upstream(upstream),
+        m_ChunkSize(round_up(std::max<std::size_t>(chunk_size, 256), alignof(std::max_align_t)))
+    {}
+
+    Arena::~Arena() {
+        release();
+    }
+
+    void Arena::reset() {
+        m_Current = m_Head;
+        m_Cursor  = m_Head ? m_Head->begin() : nullptr;
+        m_End     = m_Head ? m_Head->end() : nullptr;
+        m_Used    = 0;
+    }
+
+    void Arena::release() {
+        for (Chunk* chunk = m_Head; chunk;) {
+            Chunk* next = chunk->next;
+            m_Upstream->deallocate(chunk, chunk->size, alignof(std::max_align_t));
+            chunk = next;
+        }
+        m_Head     = nullptr;
+        m_Reserved = 0;
+        reset();
+    }
+
+    void* Arena::do_allocate(std::size_t bytes, std::size_t alignment) {
+        // The padding is measured against the room left, so aligning near the end can't step past it.
+        std::size_t pad = m_Cursor ? padding(m_Cursor, alignment) : 0;
+        if (!m_Cursor || static_cast<std::size_t>(m_End - m_Cursor) < pad ||
+            static_cast<std::size_t>(m_End - m_Cursor) - pad < bytes) {
+            next_chunk(bytes, alignment);
+            pad = padding(m_Cursor, alignment);
+        }
+        std::byte* p = m_Cursor + pad;
+        m_Cursor = p + bytes;
+        m_Used  += bytes;
+        return p;
+    }
+
+    // Move on to the next kept chunk if the request fits there, otherwise insert a new one after the current.
+    void Arena::next_chunk(std::size_t bytes, std::size_t alignment) {
+        std::size_t need = sizeof(Chunk) + bytes + alignment;
+        Chunk* next = m_Current ? m_Current->next : m_Head;
+        if (!next || next->size < need) {
+            std::size_t size = round_up(std::max(m_ChunkSize, need), alignof(std::max_align_t));
+            auto* chunk = static_cast<Chunk*>(m_Upstream->allocate(size, alignof(std::max_align_t)));
+            chunk->next = next;
+            chunk->size = size;
+            (m_Current ? m_Current->next : m_Head) = chunk;
+            m_Reserved += size;
+            next = chunk;
+        }
+        m_Current = next;
+        m_Cursor  = next->begin();
+        m_End     = next->end();
+    }
+
+    struct NodePool::Chunk {
+        Chunk* next;
+    };
+
+    NodePool::NodePool(std::size_t block_size, std::size_t blocks_per_chunk, std::pmr::memory_resource* upstream) :
+        m_Upstream(upstream),
+        // Every block is max_align_t aligned and big enough to hold the free list link.
+        m_BlockSize((std::max(block_size, sizeof(Block)) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t)),
+        m_BlocksPerChunk(std::max<std::size_t>(blocks_per_chunk, 1))
+    {}
+
+    NodePool::~NodePool() {
+        release();
+    }
+
+    void NodePool::release() {
+        std::size_t chunk_bytes = alignof(std::max_align_t) + m_BlockSize * m_BlocksPerChunk;
+        for (Chunk* chunk = m_Chunks; chunk;) {
+            Chunk* next = chunk->next;
+            m_Upstream->deallocate(chunk, chunk_bytes, alignof(std::max_align_t));
+            chunk = next;
+        }
+        m_Chunks = nullptr;
+        m_Free   = nullptr;
+    }
+
+    void* NodePool::do_allocate(std::size_t bytes, std::size_t alignment) {
+        if (!pooled(bytes, alignment)) {
+            return m_Upstream->allocate(bytes, alignment);
+        }
+        if (!m_Free) {
+            // The chunk link takes one max_align_t slot, the blocks follow it.
+            std::size_t chunk_bytes = alignof(std::max_align_t) + m_BlockSize * m_BlocksPerChunk;
+            auto* chunk = static_cast<Chunk*>(m_Upstream->allocate(chunk_bytes, alignof(std::max_align_t)));
+            chunk->next = m_Chunks;
+            m_Chunks    = chunk;
+            std::byte* blocks = reinterpret_cast<std::byte*>(chunk) + alignof(std::max_align_t);
+            for (std::size_t i = m_BlocksPerChunk; i-- > 0;) {
+                auto* block = reinterpret_cast<Block*>(blocks + i * m_BlockSize);
+                block->next = m_Free;
+                m_Free      = block;
+            }
+        }
+        Block* block = m_Free;
+        m_Free = block->next;
+        return block;
+    }
+
+    void NodePool::do_deallocate(void* p, std::size_t bytes, std::size_t alignment) {
+        if (!pooled(bytes, alignment)) {
+            m_Upstream->deallocate(p, bytes, alignment);
+            return;
+        }
+        auto* block = static_cast<Block*>(p);
+        block->next = m_Free;
+        m_Free      = block;
+    }
+
+}
@@ -0,0 +1,166 @@
+#include "ArgBuffer.h"
+#include <utility>
+
+namespace aby::log {
+
+    namespace {
+
+        class TagReader {
+        public:
+            explicit TagReader(std::span<const std::byte> data) : m_Data(data), m_Pos(0) {}
+
+            bool done() const { return m_Pos >= m_Data.size(); }
+
+            template <typename T>
+            bool take(T& value) {
+                if (m_Pos + sizeof(T) > m_Data.size()) {
+                    return false;
+                }
+                std::memcpy(&value, m_Data.data() + m_Pos, sizeof(T));
+                m_Pos += sizeof(T);
+                return true;
+            }
+
+            bool take_string(std::string_view& str) {
+                u32 len = 0;
+                if (!take(len) || m_Pos + len > m_Data.size()) {
+                    return false;
+                }
+                str = std::string_view(reinterpret_cast<const char*>(m_Data.data() + m_Pos), len);
+                m_Pos += len;
+                return true;
+            }
+        private:
+            std::span<const std::byte> m_Data;
+            std::size_t                m_Pos;
+        };
+
+        template <typename T>
+        bool take_value(TagReader& reader, ArgValue& out) {
+            T value{};
+            if (!reader.take(value)) {
+                return false;
+            }
+            out.value = value;
+            return true;
+        }
+
+        template <std::size_t... I>
+        void vformat_values(std::string& out, std::string_view fmt, std::array<ArgValue, max_dynamic_args>& values, std::index_sequence<I...>) {
+            std::vformat_to(std::back_inserter(out), fmt, std::make_format_args(values[I]...));
+        }
+
+    }
+
+    auto decode_args(std::span<const std::byte> data, std::span<ArgValue> out) -> std::size_t {
+        static constexpr std::size_t malformed = static_cast<std::size_t>(-1);
+
+        TagReader   reader(data);
+        std::size_t count = 0;
+        while (!reader.done()) {
+            EArgType type{};
+            if (!reader.take(type)) {
+                return malformed;
+            }
+            ArgValue value;
+            bool ok = false;
+            switch (type) {
+                case EArgType::BOOL:    ok = take_value<bool>(reader, value);   break;
+                case EArgType::CHAR:    ok = take_value<char>(reader, value);   break;
+                case EArgType::I32:     ok = take_value<i32>(reader, value);    break;
+                case EArgType::U32:     ok = take_value<u32>(reader, value);    break;
+                case EArgType::I64:     ok = take_value<i64>(reader, value);    break;
+                case EArgType::U64:     ok = take_value<u64>(reader, value);    break;
+                case EArgType::F32:     ok = take_value<float>(reader, value);  break;
+                case EArgType::F64:     ok = take_value<double>(reader, value); break;
+                case EArgType::STRING: {
+                    std::string_view str;
+                    ok = reader.take_string(str);
+                    value.value = str;
+                    break;
+                }
+                case EArgType::POINTER: {
+                    u64 ptr = 0;
+                    ok = reader.take(ptr);
+                    value.value = reinterpret_cast<const void*>(static_cast<std::uintptr_t>(ptr));
+                    break;
+                }
+            }
+            if (!ok) {
+                return malformed;
+            }
+            if (count < out.size()) {
+                out[count] = value;
+            }
+            ++count;
+        }
+        return count;
+    }
+
+    bool convert_args_byte_order(std::span<std::byte> data, bool to_little) {
+        if constexpr (std::endian::native == std::endian::little) {
+            (void)to_little;
+            return true;
+        }
+        auto swap = [&]<typename T>(std::size_t pos) -> T {
+            T value;
+            std::memcpy(&value, data.data() + pos, sizeof(T));
+            T swapped = to_little_endian(value);
+            std::memcpy(data.data() + pos, &swapped, sizeof(T));
+            return to_little ? value : swapped; // The native value either way.
+        };
+        std::size_t pos = 0;
+        while (pos < data.size()) {
+            EArgType type{};
+            std::memcpy(&type, data.data() + pos, sizeof(type));
+            pos += sizeof(type);
+            std::size_t size = 0;
+            switch (type) {
+                case EArgType::BOOL:
+                case EArgType::CHAR:    size = 1; break;
+                case EArgType::I32:
+                case EArgType::U32:
+                case EArgType::F32:     size = 4; break;
+                case EArgType::I64:
+                case EArgType::U64:
+                case EArgType::F64:
+                case EArgType::POINTER: size = 8; break;
+                case EArgType::STRING: {
+                    if (pos + sizeof(u32) > data.size()) {
+                        return false;
+                    }
+                    auto len = swap.template operator()<u32>(pos);
+                    pos += sizeof(u32);
+                    if (len > data.size() - pos) {
+                        return false;
+                    }
+                    pos += len;
+                    continue;
+                }
+                default:
+                    return false;
+            }
+            if (size > data.size() - pos) {
+                return false;
+            }
+            if (size == 4)      swap.template operator()<u32>(pos);
+            else if (size == 8) swap.template operator()<u64>(pos);
+            pos += size;
+        }
+        return true;
+    }
+
+    bool render_dynamic(std::string& out, std::string_view fmt, std::span<const std::byte> data) {
+        std::array<ArgValue, max_dynamic_args> values{};
+        if (decode_args(data, values) == static_cast<std::size_t>(-1)) {
+            return false;
+        }
+        try {
+            vformat_values(out, fmt, values, std::make_index_sequence<max_dynamic_args>{});
+        } catch (const std::format_error&) {
+            return false;
+        }
+        return true;
+    }
+
+}
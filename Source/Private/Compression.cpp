@@ -0,0 +1,234 @@
+#include "Compression.h"
+#include <array>
+#include <cstring>
+#include <fstream>
+
+namespace aby::lz {
+
+    namespace {
+
+        constexpr char        file_magic[6] = { 'A', 'B', 'Y', 'L', 'Z', '1' };
+        constexpr std::size_t min_match     = 4;
+        constexpr std::size_t max_offset    = 0xFFFF;
+        constexpr std::size_t hash_bits     = 14;
+        constexpr std::size_t tail_literals = 12; // Don't start matches this close to the end.
+
+        auto read32(const std::byte* p) -> u32 {
+            u32 v;
+            std::memcpy(&v, p, sizeof(v));
+            return v;
+        }
+
+        auto hash(u32 v) -> u32 {
+            return (v * 2654435761u) >> (32 - hash_bits);
+        }
+
+        void put_length(std::vector<std::byte>& dst, std::size_t len) {
+            while (len >= 255) {
+                dst.push_back(std::byte{ 255 });
+                len -= 255;
+            }
+            dst.push_back(static_cast<std::byte>(len));
+        }
+
+        void put_sequence(std::vector<std::byte>& dst, const std::byte* literals, std::size_t literal_len, std::size_t offset, std::size_t match_len) {
+            auto lit_nibble   = std::min<std::size_t>(literal_len, 15);
+            auto match_nibble = match_len ? std::min<std::size_t>(match_len - min_match, 15) : 0;
+            dst.push_back(static_cast<std::byte>((lit_nibble << 4) | match_nibble));
+            if (lit_nibble == 15) {
+                put_length(dst, literal_len - 15);
+            }
+            dst.insert(dst.end(), literals, literals + literal_len);
+            if (match_len) {
+                dst.push_back(static_cast<std::byte>(offset & 0xFF));
+                dst.push_back(static_cast<std::byte>(offset >> 8));
+                if (match_nibble == 15) {
+                    put_length(dst, match_len - min_match - 15);
+                }
+            }
+        }
+
+        bool take_length(std::span<const std::byte> src, std::size_t& pos, std::size_t& len) {
+            u8 b = 255;
+            while (b == 255) {
+                if (pos >= src.size()) {
+                    return false;
+                }
+                b = static_cast<u8>(src[pos++]);
+                len += b;
+            }
+            return true;
+        }
+
+        template <typename T>
+        bool read_value(std::FILE* f, T& value) {
+            if (std::fread(&value, sizeof(T), 1, f) != 1) {
+                return false;
+            }
+            value = to_little_endian(value);
+            return true;
+        }
+
+        template <typename T>
+        bool write_value(std::FILE* f, T value) {
+            value = to_little_endian(value);
+            return std::fwrite(&value, sizeof(T), 1, f) == 1;
+        }
+
+        auto open_file(const fs::path& path, const char* mode) -> std::FILE* {
+#ifdef _WIN32
+            std::wstring wmode(mode, mode + std::strlen(mode));
+            return _wfopen(path.c_str(), wmode.c_str());
+#else
+            return std::fopen(path.c_str(), mode);
+#endif
+        }
+
+    }
+
+    void compress_block(std::span<const std::byte> src, std::vector<std::byte>& dst) {
+        const std::byte* in = src.data();
+        std::size_t      n  = src.size();
+        std::size_t      anchor = 0;
+
+        if (n > tail_literals) {
+            std::array<u32, std::size_t(1) << hash_bits> table{}; // position + 1, 0 = empty
+            std::size_t limit = n - tail_literals;
+            std::size_t i = 0;
+            while (i < limit) {
+                u32  seq  = read32(in + i);
+                u32& slot = table[hash(seq)];
+                std::size_t cand = slot;
+                slot = static_cast<u32>(i + 1);
+
+                if (cand && i - (cand - 1) <= max_offset && read32(in + cand - 1) == seq) {
+                    std::size_t match = cand - 1;
+                    std::size_t len   = min_match;
+                    while (i + len < n - 5 && in[match + len] == in[i + len]) {
+                        ++len;
+                    }
+                    put_sequence(dst, in + anchor, i - anchor, i - match, len);
+                    i     += len;
+                    anchor = i;
+                } else {
+                    ++i;
+                }
+            }
+        }
+        put_sequence(dst, in + anchor, n - anchor, 0, 0);
+    }
+
+    bool decompress_block(std::span<const std::byte> src, std::span<std::byte> dst) {
+        std::size_t in  = 0;
+        std::size_t out = 0;
+        while (in < src.size()) {
+            auto token = static_cast<u8>(src[in++]);
+
+            std::size_t literal_len = token >> 4;
+            if (literal_len == 15 && !take_length(src, in, literal_len)) {
+                return false;
+            }
+            if (literal_len > src.size() - in || literal_len > dst.size() - out) {
+                return false;
+            }
+            std::memcpy(dst.data() + out, src.data() + in, literal_len);
+            in  += literal_len;
+            out += literal_len;
+
+            if (in == src.size()) {
+                break; // last sequence carries literals only
+            }
+
+            if (src.size() - in < 2) {
+                return false;
+            }
+            std::size_t offset = static_cast<std::size_t>(src[in]) | (static_cast<std::size_t>(src[in + 1]) << 8);
+            in += 2;
+            std::size_t match_len = (token & 0x0F);
+            if (match_len == 15 && !take_length(src, in, match_len)) {
+                return false;
+            }
+            match_len += min_match;
+            if (offset == 0 || offset > out || match_len > dst.size() - out) {
+                return false;
+            }
+            // Byte by byte, matches may overlap their own output.
+            for (std::size_t i = 0; i < match_len; ++i, ++out) {
+                dst[out] = dst[out - offset];
+            }
+        }
+        return out == dst.size();
+    }
+
+    bool compress_file(const fs::path& src, const fs::path& dst) {
+        std::FILE* in = open_file(src, "rb");
+        if (!in) {
+            return false;
+        }
+        std::FILE* out = open_file(dst, "wb");
+        if (!out) {
+            std::fclose(in);
+            return false;
+        }
+
+        bool ok = std::fwrite(file_magic, 1, sizeof(file_magic), out) == sizeof(file_magic);
+        std::vector<std::byte> raw(block_size);
+        std::vector<std::byte> packed;
+        while (ok) {
+            std::size_t got = std::fread(raw.data(), 1, raw.size(), in);
+            if (got == 0) {
+                ok = !std::ferror(in);
+                break;
+            }
+            packed.clear();
+            compress_block(std::span(raw.data(), got), packed);
+            ok = write_value(out, static_cast<u32>(got)) &&
+                 write_value(out, static_cast<u32>(packed.size())) &&
+                 std::fwrite(packed.data(), 1, packed.size(), out) == packed.size();
+        }
+        ok = ok && write_value(out, u32{ 0 });
+
+        std::fclose(in);
+        ok = std::fclose(out) == 0 && ok;
+        if (!ok) {
+            std::error_code ec;
+            fs::remove(dst, ec);
+        }
+        return ok;
+    }
+
+    bool decompress_file(const fs::path& src, std::FILE* dst) {
+        std::FILE* in = open_file(src, "rb");
+        if (!in) {
+            return false;
+        }
+
+        char magic[sizeof(file_magic)];
+        bool ok = std::fread(magic, 1, sizeof(magic), in) == sizeof(magic) && std::memcmp(magic, file_magic, sizeof(magic)) == 0;
+        std::vector<std::byte> raw;
+        std::vector<std::byte> packed;
+        while (ok) {
+            u32 raw_size = 0, packed_size = 0;
+            if (!read_value(in, raw_size)) {
+                ok = false;
+                break;
+            }
+            if (raw_size == 0) {
+                break;
+            }
+            if (raw_size > block_size || !read_value(in, packed_size) || packed_size > max_compressed_size(raw_size)) {
+                ok = false;
+                break;
+            }
+            raw.resize(raw_size);
+            packed.resize(packed_size);
+            ok = std::fread(packed.data(), 1, packed_size, in) == packed_size &&
+                 decompress_block(packed, raw) &&
+                 std::fwrite(raw.data(), 1, raw.size(), dst) == raw.size();
+        }
+
+        std::fclose(in);
+        return ok;
+    }
+
+}
@@ -0,0 +1,103 @@
+#include "Fields.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace aby::log {
+
+    bool FieldBuffer::add(const Field& field) {
+        auto mark = m_Size;
+        auto key_len = static_cast<u8>(field.key.size());
+        bool ok = field.key.size() <= UINT8_MAX && append(&key_len, sizeof(key_len)) && append(field.key.data(), field.key.size());
+        if (ok) {
+            ok = std::visit([this](const auto& v) {
+                using V = std::remove_cvref_t<decltype(v)>;
+                EFieldType type;
+                if constexpr (std::is_same_v<V, bool>)        type = EFieldType::BOOL;
+                else if constexpr (std::is_same_v<V, i64>)    type = EFieldType::I64;
+                else if constexpr (std::is_same_v<V, u64>)    type = EFieldType::U64;
+                else if constexpr (std::is_same_v<V, double>) type = EFieldType::F64;
+                else                                          type = EFieldType::STRING;
+                if (!append(&type, sizeof(type))) {
+                    return false;
+                }
+                if constexpr (std::is_same_v<V, std::string_view>) {
+                    auto len = static_cast<u32>(v.size());
+                    return append(&len, sizeof(len)) && append(v.data(), v.size());
+                } else if constexpr (std::is_same_v<V, bool>) {
+                    u64 payload = v ? 1 : 0;
+                    return append(&payload, sizeof(payload));
+                } else {
+                    return append(&v, sizeof(v));
+                }
+            }, field.value);
+        }
+        if (!ok) {
+            m_Size = mark;
+            m_Dropped += m_Dropped < UINT8_MAX ? 1 : 0;
+            return false;
+        }
+        ++m_Count;
+        return true;
+    }
+
+    bool FieldBuffer::assign(std::span<const std::byte> bytes, std::size_t count) {
+        clear();
+        if (bytes.size() > capacity) {
+            return false;
+        }
+        if (!bytes.empty()) {
+            std::memcpy(m_Data.data(), bytes.data(), bytes.size());
+        }
+        m_Size  = static_cast<u16>(bytes.size());
+        m_Count = static_cast<u8>(count);
+        return true;
+    }
+
+    auto FieldBuffer::find(std::string_view key) const -> std::optional<FieldValue> {
+        for (const auto& field : *this) {
+            if (field.key == key) {
+                return field.value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    // The buffer was written by add(), so the layout is trusted. A short tail ends the iteration.
+    void FieldBuffer::Iterator::decode() {
+        auto remaining = [&](const std::byte* p) { return static_cast<std::size_t>(m_End - p); };
+        const std::byte* p = m_Pos;
+        if (p == m_End) {
+            return;
+        }
+        auto key_len = static_cast<u8>(*p++);
+        if (remaining(p) < key_len + sizeof(EFieldType) + sizeof(u32)) {
+            m_Pos = m_End;
+            return;
+        }
+        m_Field.key = std::string_view(reinterpret_cast<const char*>(p), key_len);
+        p += key_len;
+        auto type = static_cast<EFieldType>(*p++);
+        if (type == EFieldType::STRING) {
+            u32 len = 0;
+            std::memcpy(&len, p, sizeof(len));
+            p += sizeof(len);
+            len = static_cast<u32>(std::min<std::size_t>(len, remaining(p)));
+            m_Field.value = std::string_view(reinterpret_cast<const char*>(p), len);
+            m_Next = p + len;
+            return;
+        }
+        if (remaining(p) < sizeof(u64)) {
+            m_Pos = m_End;
+            return;
+        }
+        switch (type) {
+            case EFieldType::BOOL: { u64 v;    std::memcpy(&v, p, sizeof(v)); m_Field.value = v != 0; break; }
+            case EFieldType::I64:  { i64 v;    std::memcpy(&v, p, sizeof(v)); m_Field.value = v;      break; }
+            case EFieldType::U64:  { u64 v;    std::memcpy(&v, p, sizeof(v)); m_Field.value = v;      break; }
+            case EFieldType::F64:  { double v; std::memcpy(&v, p, sizeof(v)); m_Field.value = v;      break; }
+            default:               m_Pos = m_End; return;
+        }
+        m_Next = p + sizeof(u64);
+    }
+
+}
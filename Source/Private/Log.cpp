@@ -1,28 +1,383 @@
 #include "Log.h"
 #include "Macros.h"
+#include "Profiler.h"
+#include "containers/FrozenBiMap.hpp"
+#include "sinks/ConsoleSink.h"
+#include "sinks/FileSink.h"
+#include "sinks/Sink.h"
+#include <algorithm>
 #include <chrono>
+#include <condition_variable>
+#include <utility>
 
 namespace aby::log {
 
+    namespace {
+        // Set on a backend thread to the logger it drains.
+        thread_local const Logger* t_BackendOwner = nullptr;
+        // Loggers whose callbacks this thread is running, innermost first. Per thread, so another thread
+        // logging while callbacks run elsewhere (e.g. a staged batch) is not mistaken for reentry.
+        // A callback logging to a different logger pushes another frame.
+        struct CallbackFrame {
+            const Logger*        logger;
+            const CallbackFrame* outer;
+        };
+        thread_local const CallbackFrame* t_Callbacks = nullptr;
+
+        bool in_callbacks_of(const Logger* logger) {
+            for (auto* frame = t_Callbacks; frame; frame = frame->outer) {
+                if (frame->logger == logger) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Defined ahead of s_Logger so they outlive it.
+        const Ref<IFormatter> plain_formatter   = create_ref<TextFormatter>(false);
+        const Ref<IFormatter> colored_formatter = create_ref<TextFormatter>(true);
+
+        // Built at compile time, Config::level_names starts from a copy.
+        constexpr auto default_level_names = containers::make_frozen_bimap<ELevel, std::string_view>({
+            { ELevel::NONE,     "<NONE>" },
+            { ELevel::TRACE,    "TRACE"  },
+            { ELevel::INFO,     "INFO"   },
+            { ELevel::WARN,     "WARN"   },
+            { ELevel::DEBUG,    "DEBUG"  },
+            { ELevel::ERROR,    "ERROR"  },
+            { ELevel::ASSERT,   "ASSERT" },
+            { ELevel::ALL,      "<ALL>"  },
+        });
+    }
+
+    /**
+    * @brief One thread's formatted lines waiting to be handed to the outputs.
+    *        Only its thread appends, the mutex is contended only by flush() and the flusher.
+    */
+    struct Logger::Stage {
+        struct Entry {
+            ELevel level;
+            u32    offset;        // Line start in text.
+            u32    size;
+            u32    timestamp_size; // Timestamp starts right after the line's '['.
+            u32    console_size;   // The line's size in console, if that is used.
+            u32    fields_offset;  // FieldBuffer bytes in fields.
+            u16    fields_size;
+            u8     field_count;
+        };
+
+        std::mutex                            mutex;
+        std::string                           text;    // Lines without colors, for files and callbacks.
+        std::string                           console; // The same lines with level colors, if the console wants them.
+        std::vector<Entry>                    entries;
+        std::vector<std::byte>                fields;
+        ELevel                                level = ELevel::NONE; // Most urgent level staged.
+        std::chrono::steady_clock::time_point oldest;
+        TimestampCache                        timestamps;
+        std::string                           scratch; // Rendering deferred records.
+    };
+
+    // Lock order: registry, then stage, then Logger::m_Mutex.
+    struct Logger::StageRegistry {
+        std::mutex                mutex;
+        Logger*                   owner = nullptr; // Cleared when the logger is destroyed.
+        std::vector<Ref<Stage>>   stages;
+        std::condition_variable   wake;            // Wakes the flusher early to stop.
+        bool                      bFlusherStopping = false;
+    };
+
+    // A thread's stages, one per logger it stages for. Thread exit hands over what is still staged and unregisters them.
+    struct Logger::StageHandle {
+        struct Entry {
+            Ref<StageRegistry> registry;
+            Ref<Stage>         stage;
+        };
+        std::vector<Entry> entries; // Most recently used first.
+
+        ~StageHandle() {
+            // Back to front, the registry of an entry may die with the last reference and must outlive the lock.
+            while (!entries.empty()) {
+                auto entry = std::move(entries.back());
+                entries.pop_back();
+                std::scoped_lock lock(entry.registry->mutex);
+                if (entry.registry->owner) {
+                    std::scoped_lock stage_lock(entry.stage->mutex);
+                    entry.registry->owner->drain_stage(*entry.stage);
+                }
+                std::erase(entry.registry->stages, entry.stage);
+            }
+        }
+
+        auto attach(const Ref<StageRegistry>& registry) -> Stage& {
+            auto it = std::ranges::find(entries, registry, &Entry::registry);
+            if (it == entries.end()) {
+                // Stages of destroyed loggers were drained by them, they are only kept around until the next new one.
+                std::erase_if(entries, [](const Entry& entry) {
+                    std::scoped_lock lock(entry.registry->mutex);
+                    return entry.registry->owner == nullptr;
+                });
+                auto stage = create_ref<Stage>();
+                {
+                    std::scoped_lock lock(registry->mutex);
+                    registry->stages.push_back(stage);
+                }
+                entries.push_back({ registry, std::move(stage) });
+                it = std::prev(entries.end());
+            }
+            std::rotate(entries.begin(), it, std::next(it));
+            return *entries.front().stage;
+        }
+    };
+
+    /**
+    * @brief One thread's producer-side counters for one logger. Only that thread writes them,
+    *        so counting is a plain relaxed store (see Counter), metrics() sums all blocks.
+    */
+    struct Logger::ThreadMetrics {
+        std::array<Counter, level_count> messages;
+        Counter                          blocked;
+        Counter                          fields_dropped;
+        Counter                          lock_acquisitions;
+        Counter                          lock_contended;
+        Histogram                        lock_wait;
+        Histogram                        enqueue_wait;
+
+        // Adds this block to out.
+        void collect(MetricsSnapshot& out) const {
+            for (std::size_t i = 0; i < level_count; ++i) {
+                out.messages[i] += messages[i].load();
+            }
+            out.blocked           += blocked.load();
+            out.fields_dropped    += fields_dropped.load();
+            out.lock_acquisitions += lock_acquisitions.load();
+            out.lock_contended    += lock_contended.load();
+            lock_wait.collect(out.lock_wait);
+            enqueue_wait.collect(out.enqueue_wait);
+        }
+    };
+
+    struct Logger::MetricsRegistry {
+        std::mutex                      mutex;
+        const Logger*                   owner = nullptr; // Cleared when the logger is destroyed.
+        std::vector<Ref<ThreadMetrics>> threads;
+        MetricsSnapshot                 retired;         // Counters of threads that have exited.
+    };
+
+    // A thread's blocks, one per logger it has logged to. Thread exit folds them into their registries.
+    struct Logger::MetricsHandle {
+        struct Entry {
+            Ref<MetricsRegistry> registry;
+            Ref<ThreadMetrics>   metrics;
+        };
+        std::vector<Entry> entries; // Most recently used first.
+
+        ~MetricsHandle() {
+            for (auto& entry : entries) {
+                std::scoped_lock lock(entry.registry->mutex);
+                entry.metrics->collect(entry.registry->retired);
+                std::erase(entry.registry->threads, entry.metrics);
+            }
+        }
+
+        auto attach(const Ref<MetricsRegistry>& registry) -> ThreadMetrics& {
+            auto it = std::ranges::find(entries, registry, &Entry::registry);
+            if (it == entries.end()) {
+                // Blocks of destroyed loggers are only kept around until the next new one.
+                std::erase_if(entries, [](const Entry& entry) {
+                    std::scoped_lock lock(entry.registry->mutex);
+                    return entry.registry->owner == nullptr;
+                });
+                auto metrics = create_ref<ThreadMetrics>();
+                {
+                    std::scoped_lock lock(registry->mutex);
+                    registry->threads.push_back(metrics);
+                }
+                entries.push_back({ registry, std::move(metrics) });
+                it = std::prev(entries.end());
+            }
+            std::rotate(entries.begin(), it, std::next(it));
+            return *entries.front().metrics;
+        }
+    };
+
+    /**
+    * @brief Thread and queue behind an ECallbackMode::WORKER subscription.
+    *        Dispatch only copies the message into the queue. Errors the callback returns are
+    *        handed back to the logger, which writes them on its next dispatch or flush.
+    */
+    class CallbackWorker {
+    public:
+        CallbackWorker(Logger& logger, const Subscription& subscription) :
+            m_Logger(logger),
+            m_Callback(subscription.callback),
+            m_Overflow(subscription.overflow),
+            m_Queue(subscription.queue_capacity)
+        {
+            m_Thread = std::thread(&CallbackWorker::run, this);
+        }
+
+        ~CallbackWorker() {
+            m_bStopping.store(true, std::memory_order_release);
+            m_Pushed.fetch_add(1, std::memory_order_release);
+            m_Pushed.notify_one();
+            m_Thread.join();
+        }
+
+        CallbackWorker(const CallbackWorker&) = delete;
+        CallbackWorker& operator=(const CallbackWorker&) = delete;
+
+        void push(const Message& message) {
+            Message copy = message;
+            if (!m_Queue.try_push(std::move(copy))) {
+                switch (m_Overflow) {
+                    case EOverflowPolicy::BLOCK:
+                        m_Blocked.fetch_add(1, std::memory_order_relaxed);
+                        while (!m_Queue.try_push(std::move(copy))) {
+                            std::this_thread::yield();
+                        }
+                        break;
+                    case EOverflowPolicy::DROP_NEWEST:
+                        m_Dropped.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    case EOverflowPolicy::DROP_OLDEST: {
+                        Message oldest;
+                        while (!m_Queue.try_push(std::move(copy))) {
+                            if (m_Queue.try_pop(oldest)) {
+                                m_Dropped.fetch_add(1, std::memory_order_relaxed);
+                                finish();
+                            }
+                        }
+                        break;
+                    }
+                }
+            }
+            m_Accepted.fetch_add(1, std::memory_order_relaxed);
+            m_Pushed.fetch_add(1, std::memory_order_release);
+            m_Pushed.notify_one();
+        }
+
+        // Wait until everything pushed so far has been handled.
+        void wait_idle() {
+            u64 target = m_Accepted.load(std::memory_order_relaxed);
+            u64 done   = m_Finished.load(std::memory_order_acquire);
+            while (done < target) {
+                m_Finished.wait(done, std::memory_order_acquire);
+                done = m_Finished.load(std::memory_order_acquire);
+            }
+        }
+
+        auto stats() const -> CallbackStats {
+            CallbackStats stats{
+                .delivered = m_Delivered.load(std::memory_order_relaxed),
+                .dropped   = m_Dropped.load(std::memory_order_relaxed),
+                .blocked   = m_Blocked.load(std::memory_order_relaxed),
+                .queued    = m_Queue.size_approx(),
+                .latency   = {},
+            };
+            m_Latency.collect(stats.latency);
+            return stats;
+        }
+    private:
+        void run() {
+            // Same rule as inline callbacks, a callback must not log to its own logger.
+            CallbackFrame frame{ &m_Logger, nullptr };
+            t_Callbacks = &frame;
+            Message message;
+            while (true) {
+                // Read the wake counter before popping, so a push in between makes wait() return at once.
+                u64 seen = m_Pushed.load(std::memory_order_acquire);
+                if (m_Queue.try_pop(message)) {
+                    auto start = std::chrono::steady_clock::now();
+                    auto err   = m_Callback(message);
+                    m_Latency.record(std::chrono::steady_clock::now() - start);
+                    if (err.has_value()) {
+                        std::scoped_lock lock(m_Logger.m_WorkerErrorsMutex);
+                        m_Logger.m_WorkerErrors.push_back(std::move(err.value()));
+                        m_Logger.m_bWorkerErrors.store(true, std::memory_order_release);
+                    }
+                    m_Delivered.fetch_add(1, std::memory_order_relaxed);
+                    finish();
+                    continue;
+                }
+                if (m_bStopping.load(std::memory_order_acquire)) {
+                    break;
+                }
+                m_Pushed.wait(seen, std::memory_order_acquire);
+            }
+        }
+
+        void finish() {
+            m_Finished.fetch_add(1, std::memory_order_release);
+            m_Finished.notify_all();
+        }
+    private:
+        Logger&                           m_Logger;
+        Callback                          m_Callback;
+        EOverflowPolicy                   m_Overflow;
+        containers::BoundedQueue<Message> m_Queue;
+        std::thread                       m_Thread;
+        std::atomic<u64>                  m_Pushed{ 0 };   // Wake counter.
+        std::atomic<u64>                  m_Accepted{ 0 };
+        std::atomic<u64>                  m_Finished{ 0 }; // Delivered, or dropped after being accepted.
+        std::atomic<u64>                  m_Delivered{ 0 };
+        std::atomic<u64>                  m_Dropped{ 0 };
+        std::atomic<u64>                  m_Blocked{ 0 };
+        std::atomic<bool>                 m_bStopping{ false };
+        Histogram                         m_Latency; // Written by the worker thread only.
+    };
+
+    // Runtime side of one Config::callbacks entry.
+    struct Logger::Subscriber {
+        LevelMask               levels;
+        ECallbackMode           mode;
+        std::size_t             queue_capacity;
+        EOverflowPolicy         overflow;
+        u64                     generation;    // Subscription::generation of the callback the worker copied.
+        u64                     delivered = 0; // INLINE only, the worker counts its own.
+        Unique<Histogram>       latency;       // INLINE only, written under m_Mutex. Boxed so Subscriber stays movable.
+        Unique<CallbackWorker>  worker;
+
+        Subscriber(Logger& logger, const Subscription& subscription) :
+            levels(subscription.levels),
+            mode(subscription.mode),
+            queue_capacity(subscription.queue_capacity),
+            overflow(subscription.overflow),
+            generation(subscription.generation),
+            latency(mode == ECallbackMode::INLINE ? create_unique<Histogram>() : nullptr),
+            worker(mode == ECallbackMode::WORKER ? create_unique<CallbackWorker>(logger, subscription) : nullptr)
+        {}
+
+        bool matches(const Subscription& subscription) const {
+            return levels == subscription.levels && mode == subscription.mode &&
+                (mode == ECallbackMode::INLINE || (queue_capacity == subscription.queue_capacity && overflow == subscription.overflow &&
+                                                   generation == subscription.generation));
+        }
+    };
+
     Logger Logger::s_Logger;
 
-    Logger::Logger() :
-        bInCallbacks(false),
+    namespace {
+        // Named loggers. Constructed after s_Logger, so they are destroyed (and flushed) before it.
+        struct LoggerRegistry {
+            std::mutex                                         mutex;
+            std::map<std::string, Unique<Logger>, std::less<>> loggers;
+        };
+
+        auto logger_registry() -> LoggerRegistry& {
+            static LoggerRegistry registry;
+            return registry;
+        }
+    }
+
+    Logger::Logger(std::string name) :
+        m_Name(std::move(name)),
         m_Cfg(Config{
             .level = ELevel::ALL,
             .to_console = true,
+            .console = create_ref<ConsoleSink>(),
             .log_files = {},
             .callbacks = {},
-            .level_names = {
-                { ELevel::NONE,     "<NONE>" },
-                { ELevel::TRACE,    "TRACE"  },
-                { ELevel::INFO,     "INFO"   },
-                { ELevel::WARN,     "WARN"   },
-                { ELevel::DEBUG,    "DEBUG"  },
-                { ELevel::ERROR,    "ERROR"  },
-                { ELevel::ASSERT,   "ASSERT" },
-                { ELevel::ALL,      "<ALL>"  },
-            },
+            .level_names = { default_level_names.begin(), default_level_names.end() },
             .level_colors = {
                 { ELevel::NONE,     "<NONE>"     },
                 { ELevel::TRACE,    COLOR_WHITE  },
@@ -33,46 +388,124 @@ namespace aby::log {
                 { ELevel::ASSERT,   STYLE_UNDERLINE COLOR_RED },
                 { ELevel::ALL,      "<ALL>"      },
             }
-        }) {}
+        }),
+        m_Archiver(SegmentArchiver::shared()),
+        m_Metrics(create_ref<MetricsRegistry>()),
+        m_SubscribedLevels(0),
+        m_Stages(create_ref<StageRegistry>())
+    {
+        m_Stages->owner  = this;
+        m_Metrics->owner = this;
+    }
 
     auto Logger::get() -> Logger& {
         return s_Logger;
     }
 
+    auto Logger::get(std::string_view name) -> Logger& {
+        if (name == s_Logger.name()) {
+            return s_Logger;
+        }
+        auto& registry = logger_registry();
+        std::scoped_lock lock(registry.mutex);
+        auto it = registry.loggers.find(name);
+        if (it == registry.loggers.end()) {
+            it = registry.loggers.emplace(std::string(name), create_unique<Logger>(std::string(name))).first;
+        }
+        return *it->second;
+    }
+
+    auto Logger::find(std::string_view name) -> Logger* {
+        if (name == s_Logger.name()) {
+            return &s_Logger;
+        }
+        auto& registry = logger_registry();
+        std::scoped_lock lock(registry.mutex);
+        auto it = registry.loggers.find(name);
+        return it != registry.loggers.end() ? it->second.get() : nullptr;
+    }
+
+    auto Logger::name() const -> const std::string& {
+        return m_Name;
+    }
+
     auto Logger::config() -> Config& {
         return m_Cfg;
     }
 
+    Logger::~Logger() {
+        stop_backend();
+        stop_flusher();
+        {
+            // Threads still alive keep their handle, detach them from this logger.
+            std::scoped_lock lock(m_Stages->mutex);
+            for (auto& stage : m_Stages->stages) {
+                std::scoped_lock stage_lock(stage->mutex);
+                drain_stage(*stage);
+            }
+            m_Stages->owner = nullptr;
+        }
+        report_limiters(true, true);
+        {
+            std::scoped_lock lock(m_LimitersMutex);
+            for (auto& tracked : m_Limiters) {
+                tracked.limiter->untrack();
+            }
+        }
+        // Workers finish their queues before the callbacks they hold go away.
+        m_Subscribers.clear();
+        flush_outputs();
+        // Let this logger's queued segments finish compressing, their events are not delivered anymore.
+        m_Archiver->wait(this);
+        std::scoped_lock lock(m_Metrics->mutex);
+        m_Metrics->owner = nullptr;
+    }
+
     void Logger::write(ELevel level, const std::string& msg) {
-        if (static_cast<int>(level) > static_cast<int>(m_Cfg.level)) {
+        if (!enabled(level)) {
+            return;
+        }
+        Record record;
+        record.level = level;
+        record.time  = timestamp_now(m_Cfg.time_precision);
+        record.text  = msg;
+        submit(std::move(record));
+    }
+
+    void Logger::submit(Record&& record) {
+        auto& metrics = thread_metrics();
+        metrics.messages[static_cast<std::size_t>(record.level)].add();
+        if (auto dropped = record.fields.dropped()) {
+            metrics.fields_dropped.add(dropped);
+        }
+        if (m_Cfg.async) {
+            // Inline callbacks run on the backend thread, so a call from there is a callback calling back in.
+            // A worker callback would feed its own queue forever, and under BLOCK deadlock with the backend.
+            if (t_BackendOwner == this || in_callbacks_of(this)) {
+                abort_reentrant();
+            }
+            while (!enter_queue()) {
+                start_backend();
+            }
+            enqueue(std::move(record), m_Cfg.overflow, &metrics);
+            leave_queue();
             return;
         }
         
-        if (bInCallbacks) {
-            write_console(format(ELevel::ASSERT, std::format("File:  {}:{}", ABY_SOURCE_FILE, __LINE__)));
-            write_console(format(ELevel::ASSERT, std::format("Func:  {}",  ABY_FUNC_SIG)));
-            write_console(format(ELevel::ASSERT, std::format("Expr:  {}", "Logger::bInCallbacks == true")));
-            write_console(format(ELevel::ASSERT, std::format("Error: {}", "Cannot call Logger::* functions inside of a callback.\n"
-            "Use return mechanism if you need to log an error inside a callback.")));
-            std::abort();
+        if (in_callbacks_of(this)) {
+            abort_reentrant();
         }
 
-        std::scoped_lock lock(m_Mutex);
-
-        auto formatted_msg = format(level, msg);
-        write_files(formatted_msg);
-        
-        if (m_Cfg.to_console) {
-            write_console(formatted_msg);
+        if (m_bBackendRunning.load(std::memory_order_acquire)) {
+            // Switched back to sync mode, drain what is queued so ordering is kept.
+            stop_backend();
         }
 
-        if (!m_Cfg.callbacks.empty()) {
-            Message message;
-            message.level     = level;
-            message.text      = formatted_msg;
-            message.timestamp = current_time();
-            handle_callbacks(message);
+        if (m_Cfg.staging.enabled && stageable()) {
+            stage(record);
+            return;
         }
+        dispatch(record);
     }
 
     void Logger::trace(const std::string& msg) {
@@ -100,49 +533,807 @@ namespace aby::log {
         write(ELevel::ASSERT, std::format("Func:  {}", func));
         write(ELevel::ASSERT, std::format("Expr:  {}", expr));
         write(ELevel::ASSERT, std::format("Error: {}", msg));
+        flush();
+    }
+
+    void Logger::report_suppressed(const CallSite& site, u64 count) {
+        write(site.level, std::format("Suppressed {} similar messages from {}:{}", count, site.file, site.line));
+    }
+
+    void Logger::track_limiter(const CallSite& site, Limiter& limiter) {
+        std::scoped_lock lock(m_LimitersMutex);
+        m_Limiters.push_back({ &site, &limiter });
+        m_bLimiters.store(true, std::memory_order_release);
+    }
+
+    void Logger::report_limiters(bool all, bool direct) {
+        if (!m_bLimiters.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::vector<std::pair<const CallSite*, u64>> pending;
+        {
+            std::scoped_lock lock(m_LimitersMutex);
+            for (auto& tracked : m_Limiters) {
+                if (auto count = tracked.limiter->take_suppressed(all)) {
+                    pending.emplace_back(tracked.site, count);
+                }
+            }
+        }
+        for (auto [site, count] : pending) {
+            if (!direct) {
+                report_suppressed(*site, count);
+            } else if (enabled(site->level)) {
+                Record record;
+                record.level = site->level;
+                record.time  = timestamp_now(m_Cfg.time_precision);
+                record.text  = std::format("Suppressed {} similar messages from {}:{}", count, site->file, site->line);
+                dispatch(record);
+            }
+        }
     }
 
+    void Logger::flush() {
+        // From a callback this would wait for the callback itself (its worker, or the lock held around it).
+        if (in_callbacks_of(this)) {
+            abort_reentrant();
+        }
+        // Queued like any message, so the fence below covers the summaries too.
+        report_limiters(true, t_BackendOwner == this);
+        if (t_BackendOwner != this && enter_queue()) {
+            // Fence ids are issued after everything this thread already queued, so once
+            // the backend (or stop_backend's drain) reports an id at least as large, all of it has been written.
+            u64 fence = m_FenceIssued.fetch_add(1, std::memory_order_relaxed) + 1;
+            Record marker;
+            marker.fence = fence;
+            enqueue(std::move(marker), EOverflowPolicy::BLOCK);
+            leave_queue();
+            u64 done = m_FenceDone.load(std::memory_order_acquire);
+            while (done < fence) {
+                m_FenceDone.wait(done, std::memory_order_acquire);
+                done = m_FenceDone.load(std::memory_order_acquire);
+            }
+        } else {
+            drain_all_stages();
+        }
+        std::scoped_lock lock(m_Mutex);
+        // Workers never take m_Mutex, so waiting for them under it is safe.
+        for (auto& subscriber : m_Subscribers) {
+            if (subscriber.worker) {
+                subscriber.worker->wait_idle();
+            }
+        }
+        flush_outputs();
+        std::fflush(stdout);
+        deliver_events();
+    }
 
-    auto Logger::format(ELevel level, const std::string& msg) -> std::string {
-        return std::format("[{}] [{}{}{}] {}\n",
-            current_time(),
-            m_Cfg.level_colors[level],
-            m_Cfg.level_names[level],
-            COLOR_RESET,
-            msg);
+    auto Logger::dropped() const -> u64 {
+        return m_Dropped.load(std::memory_order_relaxed);
     }
 
-    void Logger::write_files(const std::string& formatted_msg) {
-        for (auto& path : m_Cfg.log_files) {
-            std::ofstream ofs(path, std::ios::app);
-            if (ofs.is_open()) {
-                ofs << formatted_msg;
-                ofs.flush();
+    auto Logger::callback_stats() -> std::vector<CallbackStats> {
+        std::scoped_lock lock(m_Mutex);
+        sync_subscribers();
+        std::vector<CallbackStats> stats;
+        stats.reserve(m_Subscribers.size());
+        for (auto& subscriber : m_Subscribers) {
+            if (subscriber.worker) {
+                stats.push_back(subscriber.worker->stats());
+            } else {
+                auto& inline_stats = stats.emplace_back();
+                inline_stats.delivered = subscriber.delivered;
+                subscriber.latency->collect(inline_stats.latency);
             }
         }
+        return stats;
     }
 
-    void Logger::write_console(const std::string& formatted_msg) {
-        std::fwrite(formatted_msg.c_str(), 1, formatted_msg.size(), stdout);
+    auto Logger::metrics() -> MetricsSnapshot {
+        MetricsSnapshot snapshot;
+        {
+            std::scoped_lock lock(m_Metrics->mutex);
+            snapshot = m_Metrics->retired;
+            for (const auto& thread : m_Metrics->threads) {
+                thread->collect(snapshot);
+            }
+        }
+        snapshot.taken   = std::chrono::steady_clock::now();
+        snapshot.dropped = dropped();
+        {
+            std::scoped_lock lock(m_BackendMutex);
+            if (m_bBackendRunning.load(std::memory_order_relaxed)) {
+                snapshot.queue_depth    = m_Queue->size_approx();
+                snapshot.queue_capacity = m_Queue->capacity();
+            }
+        }
+        snapshot.callbacks = callback_stats();
+
+        std::scoped_lock lock(m_Mutex);
+        snapshot.outputs.reserve(1 + m_Files.size() + m_Cfg.sinks.size());
+        if (m_Cfg.console) {
+            snapshot.outputs.push_back({ "console", true, m_Cfg.console->io_stats() });
+        }
+        for (const auto& file : m_Files) {
+            snapshot.outputs.push_back({ file->path().string(), file->is_open(), file->stats() });
+        }
+        for (std::size_t i = 0; i < m_Cfg.sinks.size(); ++i) {
+            snapshot.outputs.push_back({ std::format("sink {}", i), true, m_Cfg.sinks[i]->io_stats() });
+        }
+        return snapshot;
+    }
+
+    auto Logger::thread_metrics() -> ThreadMetrics& {
+        thread_local MetricsHandle handle;
+        // Most threads only ever log to one logger, which then sits at the front.
+        if (!handle.entries.empty() && handle.entries.front().registry == m_Metrics) {
+            return *handle.entries.front().metrics;
+        }
+        return handle.attach(m_Metrics);
+    }
+
+    auto Logger::lock_outputs(ThreadMetrics* metrics) -> std::unique_lock<std::mutex> {
+        std::unique_lock lock(m_Mutex, std::try_to_lock);
+        if (!metrics) {
+            if (!lock) {
+                lock.lock();
+            }
+            return lock;
+        }
+        // Only a contended acquisition pays for reading the clock.
+        metrics->lock_acquisitions.add();
+        if (!lock) {
+            auto start = std::chrono::steady_clock::now();
+            lock.lock();
+            metrics->lock_contended.add();
+            metrics->lock_wait.record(std::chrono::steady_clock::now() - start);
+        }
+        return lock;
+    }
+
+
+    auto Logger::format(ELevel level, const std::string& msg, bool color) -> std::string {
+        std::string out;
+        format_to(out, level, current_time(timestamp_now(m_Cfg.time_precision)), msg, color);
+        return out;
+    }
+
+    void Logger::format_to(std::string& out, ELevel level, std::string_view timestamp, std::string_view text, bool color) {
+        format_line(out, m_Cfg, level, timestamp, text, color);
+    }
+
+    auto Logger::render(const Record& record) -> std::string_view {
+        if (!record.render) {
+            return record.text;
+        }
+        m_Text.clear();
+        record.render(m_Text, record.site->fmt, record.args);
+        return m_Text;
+    }
+
+    auto Logger::rendering(const IFormatter* formatter, const FormatContext& ctx) -> std::string_view {
+        if (!formatter) {
+            formatter = TextFormatter::plain().get();
+        }
+        for (std::size_t i = 0; i < m_RenderingCount; ++i) {
+            if (m_Renderings[i].formatter == formatter) {
+                return m_Renderings[i].line;
+            }
+        }
+        if (m_RenderingCount == m_Renderings.size()) {
+            m_Renderings.emplace_back();
+        }
+        auto& entry = m_Renderings[m_RenderingCount++];
+        entry.formatter = formatter;
+        entry.line.clear();
+        formatter->format(entry.line, ctx);
+        return entry.line;
+    }
+
+    void Logger::dispatch(const Record& record) {
+        ABY_PROFILE_SCOPE("log.dispatch");
+        auto lock = lock_outputs(&thread_metrics());
+
+        // Only outputs that take the level count, deferred records are only rendered if one of them reads text.
+        auto bit       = level_bit(record.level);
+        auto console   = console_for(record.level);
+        bool files     = std::ranges::any_of(m_Cfg.log_files, [bit](const LogFile& file) { return (file.levels & bit) != 0; });
+        bool callbacks = has_subscribers(record.level);
+        bool needs_text = console || files || callbacks ||
+            std::ranges::any_of(m_Cfg.sinks, [&](const Ref<ISink>& sink) { return sink->accepts(record.level) && sink->needs_text(); });
+        if (!needs_text) {
+            for (auto& sink : m_Cfg.sinks) {
+                if (sink->accepts(record.level)) {
+                    sink->write(record, {});
+                }
+            }
+            return;
+        }
+
+        if (m_Timestamps.precision() != m_Cfg.time_precision) {
+            m_Timestamps.set_precision(m_Cfg.time_precision);
+        }
+        FormatContext ctx{ m_Cfg, record, m_Timestamps.format(record.time), render(record), m_Name };
+        m_RenderingCount = 0;
+
+        for (auto& sink : m_Cfg.sinks) {
+            if (sink->accepts(record.level)) {
+                sink->write(record, sink->needs_text() ? rendering(sink->formatter().get(), ctx) : std::string_view());
+            }
+        }
+        if (files) {
+            write_files(ctx);
+        }
+        if (console) {
+            console->write(record, rendering(console_formatter(), ctx));
+        }
+
+        if (callbacks) {
+            Message message;
+            message.level     = record.level;
+            message.text      = rendering(nullptr, ctx);
+            message.timestamp = ctx.timestamp;
+            message.fields    = record.fields;
+            handle_callbacks(message);
+        }
+        deliver_events();
+    }
+
+    void Logger::write_files(const FormatContext& ctx) {
+        if (m_Files.size() != m_Cfg.log_files.size()) {
+            open_files();
+        }
+        auto bit = level_bit(ctx.record.level);
+        for (std::size_t i = 0; i < m_Files.size(); ++i) {
+            const auto& file = m_Cfg.log_files[i];
+            if (file.levels & bit) {
+                m_Files[i]->write(ctx.record.level, rendering(file.formatter.get(), ctx));
+            }
+        }
+    }
+
+    void Logger::write_files(ELevel level, std::string_view formatted_msg) {
+        if (m_Files.size() != m_Cfg.log_files.size()) {
+            open_files();
+        }
+        for (std::size_t i = 0; i < m_Files.size(); ++i) {
+            if (m_Cfg.log_files[i].levels & level_bit(level)) {
+                m_Files[i]->write(level, formatted_msg);
+            }
+        }
+    }
+
+    void Logger::open_files() {
+        // Keep sinks whose path is unchanged so their buffers survive, open the rest.
+        std::vector<Unique<FileSink>> files;
+        files.reserve(m_Cfg.log_files.size());
+        for (std::size_t i = 0; i < m_Cfg.log_files.size(); ++i) {
+            if (i < m_Files.size() && m_Files[i]->path() == m_Cfg.log_files[i].path) {
+                files.push_back(std::move(m_Files[i]));
+            } else {
+                auto path = m_Cfg.log_files[i].path;
+                files.push_back(create_unique<FileSink>(path, m_Cfg.file_buffer_size, m_Cfg.file_flush, m_Cfg.file_rotation,
+                    [this, path](const fs::path& segment) { on_rotated(path, segment); }));
+            }
+        }
+        m_Files = std::move(files);
+    }
+
+    void Logger::flush_outputs() {
+        for (auto& file : m_Files) {
+            file->flush();
+        }
+        for (auto& sink : m_Cfg.sinks) {
+            sink->flush();
+        }
+        if (m_Cfg.console) {
+            m_Cfg.console->flush();
+        }
+    }
+
+    void Logger::flush_outputs_if_due(std::chrono::steady_clock::time_point now) {
+        for (auto& file : m_Files) {
+            file->flush_if_due(now);
+        }
+        for (auto& sink : m_Cfg.sinks) {
+            sink->flush_if_due(now);
+        }
+        if (m_Cfg.console) {
+            m_Cfg.console->flush_if_due(now);
+        }
+    }
+
+    auto Logger::console_for(ELevel level) const -> ConsoleSink* {
+        return m_Cfg.to_console && m_Cfg.console && m_Cfg.console->accepts(level) ? m_Cfg.console.get() : nullptr;
+    }
+
+    void Logger::write_console(ELevel level, std::string_view formatted_msg) {
+        if (auto console = console_for(level)) {
+            console->append(level, formatted_msg);
+            console->end_batch();
+        }
+    }
+
+    bool Logger::console_colored() const {
+        return !m_Cfg.level_colors.empty();
+    }
+
+    auto Logger::console_formatter() const -> const IFormatter* {
+        if (m_Cfg.console && m_Cfg.console->formatter()) {
+            return m_Cfg.console->formatter().get();
+        }
+        return (console_colored() ? TextFormatter::colored() : TextFormatter::plain()).get();
+    }
+
+    bool Logger::stageable() const {
+        // A staged batch goes to every file and the console as one block of lines in the text layout.
+        auto default_output = [](LevelMask levels, const Ref<IFormatter>& formatter) {
+            return takes_all_levels(levels) && !formatter;
+        };
+        return m_Cfg.sinks.empty() &&
+            std::ranges::all_of(m_Cfg.log_files, [&](const LogFile& file) { return default_output(file.levels, file.formatter); }) &&
+            (!m_Cfg.console || default_output(m_Cfg.console->levels(), m_Cfg.console->formatter()));
     }
 
     void Logger::handle_callbacks(const Message& msg) {
-        bInCallbacks = true;
-        for (auto& cb : m_Cfg.callbacks) {
-            if (auto err = cb(msg); err.has_value()) {
-                auto err_msg = format(ELevel::ERROR, err.value());
-                write_files(err_msg);
-                if (m_Cfg.to_console) {
-                    write_console(err_msg);
+        // Caller holds m_Mutex and checked has_subscribers(), so m_Subscribers matches the config.
+        auto bit = level_bit(msg.level);
+        CallbackFrame frame{ this, t_Callbacks };
+        t_Callbacks = &frame;
+        for (std::size_t i = 0; i < m_Subscribers.size(); ++i) {
+            auto& subscriber = m_Subscribers[i];
+            if (!(subscriber.levels & bit)) {
+                continue;
+            }
+            if (subscriber.worker) {
+                subscriber.worker->push(msg);
+                continue;
+            }
+            ++subscriber.delivered;
+            auto start = std::chrono::steady_clock::now();
+            auto err   = m_Cfg.callbacks[i].callback(msg);
+            subscriber.latency->record(std::chrono::steady_clock::now() - start);
+            if (err.has_value()) {
+                report_callback_error(err.value());
+            }
+        }
+        t_Callbacks = frame.outer;
+    }
+
+    bool Logger::has_subscribers(ELevel level) {
+        sync_subscribers();
+        return (m_SubscribedLevels & level_bit(level)) != 0;
+    }
+
+    void Logger::sync_subscribers() {
+        // Like open_files(), entries whose settings are unchanged keep their worker and counters.
+        const auto& subscriptions = m_Cfg.callbacks;
+        bool changed = m_Subscribers.size() != subscriptions.size();
+        for (std::size_t i = 0; !changed && i < subscriptions.size(); ++i) {
+            changed = !m_Subscribers[i].matches(subscriptions[i]);
+        }
+        if (!changed) {
+            return;
+        }
+
+        std::vector<Subscriber> subscribers;
+        subscribers.reserve(subscriptions.size());
+        m_SubscribedLevels = 0;
+        for (std::size_t i = 0; i < subscriptions.size(); ++i) {
+            if (i < m_Subscribers.size() && m_Subscribers[i].matches(subscriptions[i])) {
+                subscribers.push_back(std::move(m_Subscribers[i]));
+            } else {
+                subscribers.emplace_back(*this, subscriptions[i]);
+            }
+            m_SubscribedLevels |= subscriptions[i].levels;
+        }
+        m_Subscribers = std::move(subscribers);
+    }
+
+    void Logger::report_callback_error(std::string_view error) {
+        auto err_msg = format(ELevel::ERROR, std::string(error), false);
+        write_files(ELevel::ERROR, err_msg);
+        if (console_for(ELevel::ERROR)) {
+            write_console(ELevel::ERROR, console_colored() ? format(ELevel::ERROR, std::string(error), true) : err_msg);
+        }
+    }
+
+    void Logger::report_worker_errors() {
+        if (!m_bWorkerErrors.exchange(false, std::memory_order_acquire)) {
+            return;
+        }
+        std::vector<std::string> errors;
+        {
+            std::scoped_lock lock(m_WorkerErrorsMutex);
+            errors.swap(m_WorkerErrors);
+        }
+        for (auto& error : errors) {
+            report_callback_error(error);
+        }
+    }
+
+    void Logger::abort_reentrant() {
+        // Straight to stderr, the console sink belongs to whoever holds m_Mutex and that may be this thread.
+        auto report = [this](const std::string& text) {
+            auto line = format(ELevel::ASSERT, text, true);
+            std::fwrite(line.data(), 1, line.size(), stderr);
+        };
+        if (m_Cfg.console) {
+            m_Cfg.console->flush();
+        }
+        report(std::format("File:  {}:{}", ABY_SOURCE_FILE, __LINE__));
+        report(std::format("Func:  {}",  ABY_FUNC_SIG));
+        report(std::format("Expr:  {}", "in_callbacks_of(this)"));
+        report(std::format("Error: {}", "Cannot call Logger::* functions of a logger inside of its own callbacks.\n"
+        "Use return mechanism if you need to log an error inside a callback."));
+        std::abort();
+    }
+
+    void Logger::on_rotated(const fs::path& active, const fs::path& segment) {
+        // Runs inside FileSink::write with m_Mutex held, the slow part is left to the archiver.
+        m_Events.push_back(file_event(EMessageType::ROTATED, segment));
+        if (m_Cfg.file_rotation.compress || m_Cfg.file_rotation.keep) {
+            m_Archiver->submit(this, active, segment, m_Cfg.file_rotation,
+                [this](EMessageType type, const fs::path& file) { on_archived(type, file); });
+        }
+    }
+
+    void Logger::on_archived(EMessageType type, const fs::path& file) {
+        // Archiver thread. Queued instead of calling back here, so callbacks keep running on the writing thread.
+        std::scoped_lock lock(m_Mutex);
+        m_Events.push_back(file_event(type, file));
+    }
+
+    auto Logger::file_event(EMessageType type, const fs::path& file) -> Message {
+        std::string_view what;
+        switch (type) {
+            case EMessageType::ROTATED:    what = "Rotated log segment";    break;
+            case EMessageType::COMPRESSED: what = "Compressed log segment"; break;
+            case EMessageType::REMOVED:    what = "Removed log segment";    break;
+            case EMessageType::LOG:        break;
+        }
+        Message message;
+        message.level     = ELevel::INFO;
+        message.type      = type;
+        message.file      = file;
+        message.timestamp = m_Timestamps.format(std::chrono::system_clock::now());
+        format_to(message.text, message.level, message.timestamp, std::format("{} '{}'", what, file.string()), false);
+        return message;
+    }
+
+    void Logger::deliver_events() {
+        report_worker_errors();
+        if (m_Events.empty() || in_callbacks_of(this)) {
+            return;
+        }
+        auto events = std::move(m_Events);
+        m_Events.clear();
+        for (auto& event : events) {
+            if (has_subscribers(event.level)) {
+                handle_callbacks(event);
+            }
+        }
+    }
+
+}
+
+namespace aby::log {
+
+    void Logger::enqueue(Record&& record, EOverflowPolicy policy, ThreadMetrics* metrics) {
+        if (m_Queue->try_push(std::move(record))) {
+            return;
+        }
+        switch (policy) {
+            case EOverflowPolicy::BLOCK: {
+                auto start = std::chrono::steady_clock::now();
+                while (!m_Queue->try_push(std::move(record))) {
+                    std::this_thread::yield();
                 }
+                if (metrics) {
+                    metrics->blocked.add();
+                    metrics->enqueue_wait.record(std::chrono::steady_clock::now() - start);
+                }
+                break;
+            }
+            case EOverflowPolicy::DROP_NEWEST:
+                m_Dropped.fetch_add(1, std::memory_order_relaxed);
+                break;
+            case EOverflowPolicy::DROP_OLDEST: {
+                Record oldest;
+                while (!m_Queue->try_push(std::move(record))) {
+                    if (!m_Queue->try_pop(oldest)) {
+                        continue;
+                    }
+                    if (oldest.fence) {
+                        // Fences are never evicted, only the backend completes them, after flushing the outputs.
+                        // Back in behind newer records, which only makes that flush() wait a little longer.
+                        while (!m_Queue->try_push(std::move(oldest))) {
+                            std::this_thread::yield();
+                        }
+                    } else {
+                        m_Dropped.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+                break;
+            }
+        }
+    }
+
+    bool Logger::enter_queue() {
+        // Paired with stop_backend(): either it sees this producer and waits, or this sees the backend stopped.
+        m_Producers.fetch_add(1, std::memory_order_seq_cst);
+        if (m_bBackendRunning.load(std::memory_order_seq_cst)) {
+            return true;
+        }
+        leave_queue();
+        return false;
+    }
+
+    void Logger::leave_queue() {
+        m_Producers.fetch_sub(1, std::memory_order_release);
+    }
+
+    void Logger::start_backend() {
+        std::scoped_lock lock(m_BackendMutex);
+        if (m_bBackendRunning.load(std::memory_order_relaxed)) {
+            return;
+        }
+        // Created once and kept until the logger goes away, a producer that saw the backend running
+        // may still be pushing after a stop_backend().
+        if (!m_Queue) {
+            m_Queue = create_unique<Queue>(m_Cfg.queue_capacity);
+        }
+        m_bBackendStopping.store(false, std::memory_order_relaxed);
+        m_Backend = std::thread(&Logger::backend_loop, this);
+        m_bBackendRunning.store(true, std::memory_order_release);
+    }
+
+    void Logger::stop_backend() {
+        std::scoped_lock lock(m_BackendMutex);
+        if (!m_bBackendRunning.load(std::memory_order_relaxed)) {
+            return;
+        }
+        // New producers see the backend stopped, the ones already pushing finish while it still drains.
+        m_bBackendRunning.store(false, std::memory_order_seq_cst);
+        while (m_Producers.load(std::memory_order_seq_cst)) {
+            std::this_thread::yield();
+        }
+        m_bBackendStopping.store(true, std::memory_order_release);
+        m_Backend.join();
+        m_Backend = {};
+        // Pushes that landed after the backend's last pop, so no record or fence is left behind.
+        Record record;
+        while (m_Queue->try_pop(record)) {
+            consume(record);
+        }
+    }
+
+    void Logger::backend_loop() {
+        static constexpr u32 spins_before_sleep = 64;
+        static constexpr auto idle_sleep = std::chrono::microseconds(100);
+
+        t_BackendOwner = this;
+        ABY_PROFILE_THREAD("aby.log.backend");
+        Record record;
+        u32 idle = 0;
+        while (true) {
+            // Read the stop flag before popping so whatever was queued before it is still drained.
+            bool stopping = m_bBackendStopping.load(std::memory_order_acquire);
+            if (m_Queue->try_pop(record)) {
+                idle = 0;
+                consume(record);
+                continue;
+            }
+            if (stopping) {
+                break;
+            }
+            if (++idle < spins_before_sleep) {
+                std::this_thread::yield();
+            } else {
+                {
+                    std::scoped_lock lock(m_Mutex);
+                    flush_outputs_if_due(std::chrono::steady_clock::now());
+                    deliver_events();
+                }
+                report_limiters(false, true);
+                std::this_thread::sleep_for(idle_sleep);
             }
         }
-        bInCallbacks = false;
+
+        std::scoped_lock lock(m_Mutex);
+        flush_outputs();
+        std::fflush(stdout);
+    }
+
+    void Logger::consume(Record& record) {
+        if (!record.fence) {
+            dispatch(record);
+            return;
+        }
+        {
+            std::scoped_lock lock(m_Mutex);
+            flush_outputs();
+            std::fflush(stdout);
+            deliver_events();
+        }
+        complete_fence(record.fence);
+    }
+
+    void Logger::complete_fence(u64 fence) {
+        u64 done = m_FenceDone.load(std::memory_order_relaxed);
+        while (done < fence && !m_FenceDone.compare_exchange_weak(done, fence, std::memory_order_release, std::memory_order_relaxed)) {}
+        m_FenceDone.notify_all();
     }
 
 
 }
 
+namespace aby::log {
+
+    void Logger::stage(const Record& record) {
+        const auto& policy = m_Cfg.staging;
+        Stage& stage = local_stage();
+        std::scoped_lock lock(stage.mutex);
+
+        if (stage.timestamps.precision() != m_Cfg.time_precision) {
+            stage.timestamps.set_precision(m_Cfg.time_precision);
+        }
+        auto timestamp = stage.timestamps.format(record.time);
+        std::string_view text = record.text;
+        if (record.render) {
+            stage.scratch.clear();
+            record.render(stage.scratch, record.site->fmt, record.args);
+            text = stage.scratch;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (stage.entries.empty()) {
+            stage.oldest = now;
+        }
+        auto offset = stage.text.size();
+        format_line(stage.text, m_Cfg, record.level, timestamp, text, false);
+        auto console_offset = stage.console.size();
+        if (console_for(record.level) && console_colored()) {
+            format_line(stage.console, m_Cfg, record.level, timestamp, text, true);
+        }
+        auto fields = record.fields.bytes();
+        auto fields_offset = stage.fields.size();
+        stage.fields.insert(stage.fields.end(), fields.begin(), fields.end());
+        stage.entries.push_back({ record.level, static_cast<u32>(offset), static_cast<u32>(stage.text.size() - offset), static_cast<u32>(timestamp.size()),
+                                  static_cast<u32>(stage.console.size() - console_offset),
+                                  static_cast<u32>(fields_offset), static_cast<u16>(fields.size()), static_cast<u8>(record.fields.count()) });
+        stage.level = std::max(stage.level, record.level, [](ELevel a, ELevel b) { return static_cast<int>(a) < static_cast<int>(b); });
+
+        if (stage.text.size() >= policy.bytes ||
+            static_cast<int>(record.level) >= static_cast<int>(policy.level) ||
+            (policy.linger.count() && now - stage.oldest >= policy.linger)) {
+            drain_stage(stage, &thread_metrics());
+        }
+    }
+
+    auto Logger::local_stage() -> Stage& {
+        thread_local StageHandle handle;
+        // Most threads only ever stage for one logger, which then sits at the front.
+        if (!handle.entries.empty() && handle.entries.front().registry == m_Stages) {
+            return *handle.entries.front().stage;
+        }
+        auto& stage = handle.attach(m_Stages);
+        if (m_Cfg.staging.linger.count()) {
+            start_flusher();
+        }
+        return stage;
+    }
+
+    void Logger::drain_stage(Stage& stage, ThreadMetrics* metrics) {
+        // Caller holds stage.mutex. metrics is the draining producer's, the flusher and thread exit don't count.
+        if (stage.entries.empty()) {
+            return;
+        }
+
+        ABY_PROFILE_SCOPE("log.drain_stage");
+        auto lock = lock_outputs(metrics);
+        if (!m_Cfg.log_files.empty()) {
+            if (m_Files.size() != m_Cfg.log_files.size()) {
+                open_files();
+            }
+            std::string_view block = stage.text;
+            for (auto& file : m_Files) {
+                file->write_batch(std::span(&block, 1), stage.level);
+            }
+        }
+        if (auto console = console_for(stage.level)) {
+            // Stageable outputs take every level, so the console gets each line. In one piece unless some go to stderr.
+            std::string_view lines = stage.console.empty() ? stage.text : stage.console;
+            if (static_cast<int>(stage.level) < static_cast<int>(console->stderr_level())) {
+                console->append(stage.level, lines);
+            } else {
+                std::size_t offset = 0;
+                for (const auto& entry : stage.entries) {
+                    auto size = stage.console.empty() ? entry.size : entry.console_size;
+                    console->append(entry.level, lines.substr(offset, size));
+                    offset += size;
+                }
+            }
+            console->end_batch();
+        }
+        sync_subscribers();
+        if (m_SubscribedLevels) {
+            Message message;
+            for (const auto& entry : stage.entries) {
+                if (!has_subscribers(entry.level)) {
+                    continue;
+                }
+                message.level     = entry.level;
+                message.text.assign(stage.text, entry.offset, entry.size);
+                message.timestamp.assign(stage.text, entry.offset + 1, entry.timestamp_size);
+                message.fields.assign(std::span(stage.fields).subspan(entry.fields_offset, entry.fields_size), entry.field_count);
+                handle_callbacks(message);
+            }
+        }
+        deliver_events();
+
+        stage.text.clear();
+        stage.console.clear();
+        stage.entries.clear();
+        stage.fields.clear();
+        stage.level = ELevel::NONE;
+    }
+
+    void Logger::drain_all_stages() {
+        std::scoped_lock lock(m_Stages->mutex);
+        for (auto& stage : m_Stages->stages) {
+            std::scoped_lock stage_lock(stage->mutex);
+            drain_stage(*stage);
+        }
+    }
+
+    void Logger::start_flusher() {
+        std::scoped_lock lock(m_BackendMutex);
+        if (m_Flusher.joinable()) {
+            return;
+        }
+        m_Stages->bFlusherStopping = false;
+        m_Flusher = std::thread(&Logger::flusher_loop, this);
+    }
+
+    void Logger::stop_flusher() {
+        std::scoped_lock lock(m_BackendMutex);
+        if (!m_Flusher.joinable()) {
+            return;
+        }
+        {
+            std::scoped_lock registry_lock(m_Stages->mutex);
+            m_Stages->bFlusherStopping = true;
+        }
+        m_Stages->wake.notify_all();
+        m_Flusher.join();
+        m_Flusher = {};
+    }
+
+    void Logger::flusher_loop() {
+        std::unique_lock lock(m_Stages->mutex);
+        while (!m_Stages->bFlusherStopping) {
+            auto linger = m_Cfg.staging.linger;
+            // Checking twice per linger period bounds the wait to 1.5x linger at worst.
+            auto period = std::max<std::chrono::milliseconds>(linger / 2, std::chrono::milliseconds(1));
+            m_Stages->wake.wait_for(lock, period);
+
+            auto now = std::chrono::steady_clock::now();
+            for (auto& stage : m_Stages->stages) {
+                // A busy producer drains on its own, don't wait for it.
+                std::unique_lock stage_lock(stage->mutex, std::try_to_lock);
+                if (stage_lock && !stage->entries.empty() && now - stage->oldest >= linger) {
+                    drain_stage(*stage);
+                }
+            }
+            report_limiters(false, true);
+            // Outputs keep their own FlushPolicy on top of the linger, in sync mode nobody else checks it while idle.
+            std::scoped_lock out_lock(m_Mutex);
+            flush_outputs_if_due(now);
+        }
+    }
+
+}
+
 namespace aby::log {
     
     Config& Config::set_level(ELevel level) {
@@ -165,13 +1356,99 @@ namespace aby::log {
         return *this;   
     }
 
-    Config& Config::add_file(const std::filesystem::path& path) {
-        this->log_files.push_back(path);
+    Config& Config::add_file(const std::filesystem::path& path, LevelMask levels, Ref<IFormatter> formatter) {
+        this->log_files.emplace_back(path, levels, std::move(formatter));
         return *this;
     }
 
     Config& Config::add_callback(Callback&& callback) {
-        this->callbacks.push_back(std::forward<decltype(callback)>(callback));
+        this->callbacks.emplace_back(std::forward<decltype(callback)>(callback));
+        return *this;
+    }
+
+    Config& Config::subscribe(Subscription subscription) {
+        this->callbacks.push_back(std::move(subscription));
+        return *this;
+    }
+
+    auto Subscription::next_generation() -> u64 {
+        static std::atomic<u64> generation{ 0 };
+        return generation.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    Subscription& Subscription::set_callback(Callback callback) {
+        this->callback   = std::move(callback);
+        this->generation = next_generation();
+        return *this;
+    }
+
+    Subscription& Subscription::set_levels(LevelMask levels) {
+        this->levels = levels;
+        return *this;
+    }
+
+    Subscription& Subscription::set_mode(ECallbackMode mode) {
+        this->mode = mode;
+        return *this;
+    }
+
+    Subscription& Subscription::set_queue_capacity(std::size_t capacity) {
+        this->queue_capacity = capacity;
+        return *this;
+    }
+
+    Subscription& Subscription::set_overflow_policy(EOverflowPolicy policy) {
+        this->overflow = policy;
+        return *this;
+    }
+
+    Config& Config::set_async(bool async) {
+        this->async = async;
+        return *this;
+    }
+
+    Config& Config::set_queue_capacity(std::size_t capacity) {
+        this->queue_capacity = capacity;
+        return *this;
+    }
+
+    Config& Config::set_overflow_policy(EOverflowPolicy policy) {
+        this->overflow = policy;
+        return *this;
+    }
+
+    Config& Config::set_file_buffer_size(std::size_t bytes) {
+        this->file_buffer_size = bytes;
+        return *this;
+    }
+
+    Config& Config::set_file_flush_policy(const FlushPolicy& policy) {
+        this->file_flush = policy;
+        return *this;
+    }
+
+    Config& Config::set_time_precision(ETimePrecision precision) {
+        this->time_precision = precision;
+        return *this;
+    }
+
+    Config& Config::set_file_rotation(const RotationPolicy& policy) {
+        this->file_rotation = policy;
+        return *this;
+    }
+
+    Config& Config::set_staging(const StagingPolicy& policy) {
+        this->staging = policy;
+        return *this;
+    }
+
+    Config& Config::add_sink(Ref<ISink> sink) {
+        this->sinks.push_back(std::move(sink));
+        return *this;
+    }
+
+    Config& Config::set_console(Ref<ConsoleSink> console) {
+        this->console = std::move(console);
         return *this;
     }
 
@@ -180,34 +1457,43 @@ namespace aby::log {
 
 namespace aby::log {
 
+    void format_line(std::string& out, const Config& cfg, ELevel level, std::string_view timestamp, std::string_view text, bool color) {
+        auto name      = cfg.level_names.find(level);
+        auto color_it  = color ? cfg.level_colors.find(level) : cfg.level_colors.end();
+        bool has_color = color_it != cfg.level_colors.end();
+        std::format_to(std::back_inserter(out), "[{}] [{}{}{}] {}\n",
+            timestamp,
+            has_color ? std::string_view(color_it->second) : std::string_view(),
+            name != cfg.level_names.end() ? std::string_view(name->second) : std::string_view(),
+            has_color ? std::string_view(COLOR_RESET) : std::string_view(),
+            text);
+    }
+
+    void TextFormatter::format(std::string& out, const FormatContext& ctx) const {
+        format_line(out, ctx.config, ctx.record.level, ctx.timestamp, ctx.text, m_bColor);
+    }
+
+    auto TextFormatter::plain() -> const Ref<IFormatter>& {
+        return plain_formatter;
+    }
+
+    auto TextFormatter::colored() -> const Ref<IFormatter>& {
+        return colored_formatter;
+    }
+
     auto current_time() -> std::string {
-        using namespace std::chrono;
-        auto now = system_clock::now();
-        std::time_t t = system_clock::to_time_t(now);
-        std::tm tm{};
-#ifdef _WIN32
-        localtime_s(&tm, &t);
-#else
-        localtime_r(&t, &tm);
-#endif
-        static const char* months[] = {
-            "Jan","Feb","Mar","Apr","May","Jun",
-            "Jul","Aug","Sep","Oct","Nov","Dec"
-        };
-        return std::format("{:02}-{}-{:04}•{:02}:{:02}:{:02}",
-            tm.tm_mday, months[tm.tm_mon], tm.tm_year + 1900,
-            tm.tm_hour, tm.tm_min, tm.tm_sec);
+        return current_time(std::chrono::system_clock::now());
+    }
+
+    auto current_time(std::chrono::system_clock::time_point now) -> std::string {
+        thread_local TimestampCache cache;
+        return std::string(cache.format(now));
     }
 
 
     auto format_with_commas(int64_t value) -> std::string {
-        std::string num = std::to_string(value);
-        int64_t insert_position = num.length() - 3;
-        while (insert_position > 0) {
-            num.insert(insert_position, ",");
-            insert_position -= 3;
-        }
-        return num;
+        char buffer[max_grouped_chars];
+        return std::string(buffer, format_grouped(buffer, static_cast<i64>(value)));
     }
 
 }
@@ -0,0 +1,163 @@
+#include "MappedFile.h"
+#include <utility>
+
+#ifdef _WIN32
+#   define WIN32_LEAN_AND_MEAN
+#   define NOMINMAX
+#   include <windows.h>
+#else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+namespace aby {
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept {
+        swap(other);
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            swap(other);
+        }
+        return *this;
+    }
+
+    void MappedFile::swap(MappedFile& other) noexcept {
+        std::swap(m_Data, other.m_Data);
+        std::swap(m_Size, other.m_Size);
+#ifdef _WIN32
+        std::swap(m_File, other.m_File);
+        std::swap(m_Mapping, other.m_Mapping);
+#else
+        std::swap(m_Fd, other.m_Fd);
+#endif
+    }
+
+#ifdef _WIN32
+
+    bool MappedFile::open(const fs::path& path, EMode mode, std::size_t size) {
+        close();
+        bool  write  = mode == EMode::READ_WRITE;
+        DWORD access = write ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ;
+        HANDLE file  = CreateFileW(path.c_str(), access, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+            write ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER file_size{};
+        if (write) {
+            file_size.QuadPart = static_cast<LONGLONG>(size);
+            if (!SetFilePointerEx(file, file_size, nullptr, FILE_BEGIN) || !SetEndOfFile(file)) {
+                CloseHandle(file);
+                return false;
+            }
+        } else if (!GetFileSizeEx(file, &file_size)) {
+            CloseHandle(file);
+            return false;
+        }
+        if (file_size.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+        HANDLE mapping = CreateFileMappingW(file, nullptr, write ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            CloseHandle(file);
+            return false;
+        }
+        void* view = MapViewOfFile(mapping, write ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+        if (!view) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+        m_File    = file;
+        m_Mapping = mapping;
+        m_Data    = static_cast<std::byte*>(view);
+        m_Size    = static_cast<std::size_t>(file_size.QuadPart);
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (m_Data) {
+            UnmapViewOfFile(m_Data);
+        }
+        if (m_Mapping) {
+            CloseHandle(m_Mapping);
+        }
+        if (m_File) {
+            CloseHandle(m_File);
+        }
+        m_Data    = nullptr;
+        m_Size    = 0;
+        m_Mapping = nullptr;
+        m_File    = nullptr;
+    }
+
+    bool MappedFile::sync() {
+        return m_Data && FlushViewOfFile(m_Data, 0) && FlushFileBuffers(m_File);
+    }
+
+#else
+
+    bool MappedFile::open(const fs::path& path, EMode mode, std::size_t size) {
+        close();
+        bool write = mode == EMode::READ_WRITE;
+        int  fd    = ::open(path.c_str(), write ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+        if (fd < 0) {
+            return false;
+        }
+        if (write) {
+            if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+                ::close(fd);
+                return false;
+            }
+        } else {
+            struct stat st{};
+            if (::fstat(fd, &st) != 0) {
+                ::close(fd);
+                return false;
+            }
+            size = static_cast<std::size_t>(st.st_size);
+        }
+        if (size == 0) {
+            ::close(fd);
+            return false;
+        }
+        void* data = ::mmap(nullptr, size, write ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+        if (data == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+        m_Fd   = fd;
+        m_Data = static_cast<std::byte*>(data);
+        m_Size = size;
+        return true;
+    }
+
+    void MappedFile::close() {
+        if (m_Data) {
+            ::munmap(m_Data, m_Size);
+        }
+        if (m_Fd >= 0) {
+            ::close(m_Fd);
+        }
+        m_Data = nullptr;
+        m_Size = 0;
+        m_Fd   = -1;
+    }
+
+    bool MappedFile::sync() {
+        return m_Data && ::msync(m_Data, m_Size, MS_SYNC) == 0;
+    }
+
+#endif
+
+}
@@ -0,0 +1,152 @@
+#include "MetricsReporter.h"
+#include "Macros.h"
+#include "Profiler.h"
+
+namespace aby::log {
+
+    namespace {
+
+        // Counters of an output or subscription that was recreated in between start over.
+        auto counter_since(u64 now, u64 earlier) -> u64 {
+            return now >= earlier ? now - earlier : now;
+        }
+
+        auto io_since(const IoStats& now, const IoStats& earlier) -> IoStats {
+            return {
+                .bytes  = counter_since(now.bytes, earlier.bytes),
+                .writes = counter_since(now.writes, earlier.writes),
+                .errors = counter_since(now.errors, earlier.errors),
+                .lost   = counter_since(now.lost, earlier.lost),
+            };
+        }
+
+        constexpr std::string_view report_fmt = "Logger metrics: {} messages, {} dropped, {} blocked, {} write errors, lock wait p99 {}ns";
+
+        // Deferred records point at their call site, so these have to outlive any queued report.
+        constexpr CallSite report_sites[level_count] = {
+            { ABY_SOURCE_FILE, __LINE__, ELevel::NONE,   report_fmt },
+            { ABY_SOURCE_FILE, __LINE__, ELevel::TRACE,  report_fmt },
+            { ABY_SOURCE_FILE, __LINE__, ELevel::INFO,   report_fmt },
+            { ABY_SOURCE_FILE, __LINE__, ELevel::WARN,   report_fmt },
+            { ABY_SOURCE_FILE, __LINE__, ELevel::DEBUG,  report_fmt },
+            { ABY_SOURCE_FILE, __LINE__, ELevel::ERROR,  report_fmt },
+            { ABY_SOURCE_FILE, __LINE__, ELevel::ASSERT, report_fmt },
+            { ABY_SOURCE_FILE, __LINE__, ELevel::ALL,    report_fmt },
+        };
+
+    }
+
+    auto MetricsSnapshot::total_messages() const -> u64 {
+        u64 total = 0;
+        for (auto count : messages) {
+            total += count;
+        }
+        return total;
+    }
+
+    auto MetricsSnapshot::io() const -> IoStats {
+        IoStats total;
+        for (const auto& output : outputs) {
+            total += output.io;
+        }
+        return total;
+    }
+
+    auto MetricsSnapshot::since(const MetricsSnapshot& earlier) const -> MetricsSnapshot {
+        MetricsSnapshot delta = *this;
+        for (std::size_t i = 0; i < level_count; ++i) {
+            delta.messages[i] = counter_since(messages[i], earlier.messages[i]);
+        }
+        delta.dropped           = counter_since(dropped, earlier.dropped);
+        delta.blocked           = counter_since(blocked, earlier.blocked);
+        delta.fields_dropped    = counter_since(fields_dropped, earlier.fields_dropped);
+        delta.lock_acquisitions = counter_since(lock_acquisitions, earlier.lock_acquisitions);
+        delta.lock_contended    = counter_since(lock_contended, earlier.lock_contended);
+        delta.lock_wait         = lock_wait.since(earlier.lock_wait);
+        delta.enqueue_wait      = enqueue_wait.since(earlier.enqueue_wait);
+        // Outputs are matched by name, files only show up once opened.
+        for (auto& output : delta.outputs) {
+            auto it = std::ranges::find(earlier.outputs, output.name, &OutputStats::name);
+            if (it != earlier.outputs.end()) {
+                output.io = io_since(output.io, it->io);
+            }
+        }
+        for (std::size_t i = 0; i < delta.callbacks.size() && i < earlier.callbacks.size(); ++i) {
+            auto& callback = delta.callbacks[i];
+            const auto& before = earlier.callbacks[i];
+            callback.delivered = counter_since(callback.delivered, before.delivered);
+            callback.dropped   = counter_since(callback.dropped, before.dropped);
+            callback.blocked   = counter_since(callback.blocked, before.blocked);
+            callback.latency   = callback.latency.since(before.latency);
+        }
+        return delta;
+    }
+
+}
+
+namespace aby::log {
+
+    MetricsReporter::MetricsReporter(Logger& logger, std::chrono::milliseconds interval, ReportFn report, ELevel level) :
+        m_Logger(logger),
+        m_Interval(std::max(interval, std::chrono::milliseconds(1))),
+        m_Report(std::move(report)),
+        m_Level(level),
+        m_Last(logger.metrics())
+    {
+        m_Thread = std::thread(&MetricsReporter::run, this);
+    }
+
+    MetricsReporter::~MetricsReporter() {
+        {
+            std::scoped_lock lock(m_Mutex);
+            m_bStopping = true;
+        }
+        m_Wake.notify_all();
+        m_Thread.join();
+    }
+
+    void MetricsReporter::report_now() {
+        std::scoped_lock lock(m_ReportMutex);
+        auto total = m_Logger.metrics();
+        auto delta = total.since(m_Last);
+        m_Last = total;
+        if (m_Report) {
+            m_Report(total, delta);
+        } else {
+            log_report(total, delta);
+        }
+    }
+
+    void MetricsReporter::run() {
+        ABY_PROFILE_THREAD("aby.log.metrics");
+        std::unique_lock lock(m_Mutex);
+        while (!m_Wake.wait_for(lock, m_Interval, [this] { return m_bStopping; })) {
+            lock.unlock();
+            report_now();
+            lock.lock();
+        }
+    }
+
+    void MetricsReporter::log_report(const MetricsSnapshot& total, const MetricsSnapshot& delta) {
+        LatencyStats callbacks;
+        for (const auto& callback : delta.callbacks) {
+            callbacks += callback.latency;
+        }
+        auto io = delta.io();
+        u64 messages = delta.total_messages();
+        u64 lock_p99 = delta.lock_wait.percentile_ns(0.99);
+        m_Logger.log_fields(report_sites[static_cast<std::size_t>(m_Level)], {
+                { "messages",         messages },
+                { "dropped",          delta.dropped },
+                { "blocked",          delta.blocked },
+                { "fields_dropped",   delta.fields_dropped },
+                { "queue_depth",      total.queue_depth },
+                { "lock_wait_p99_ns", lock_p99 },
+                { "callback_p99_ns",  callbacks.percentile_ns(0.99) },
+                { "bytes",            io.bytes },
+                { "write_errors",     io.errors },
+            },
+            report_fmt, messages, delta.dropped, delta.blocked, io.errors, lock_p99);
+    }
+
+}
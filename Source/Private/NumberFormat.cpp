@@ -0,0 +1,123 @@
+#include "NumberFormat.h"
+#include <cmath>
+#include <string_view>
+
+namespace aby::log {
+
+    namespace {
+
+        auto write_grouped_backward(char* end, u64 value, char separator) -> char* {
+            while (value >= 1000) {
+                auto group = static_cast<std::size_t>(value % 1000);
+                value /= 1000;
+                end -= 3;
+                end[0] = static_cast<char>('0' + group / 100);
+                std::memcpy(end + 1, detail::digit_pairs.data() + (group % 100) * 2, 2);
+                *--end = separator;
+            }
+            return write_decimal_backward(end, value);
+        }
+
+        auto put(char* out, std::string_view text) -> char* {
+            std::memcpy(out, text.data(), text.size());
+            return out + text.size();
+        }
+
+        // scaled (at least 1) with three significant digits, then " unit". Returns false, writing nothing,
+        // if rounding reached carry (1000 or 1024 of the unit) and the caller should move up a unit.
+        // carry = 0 never does.
+        bool put_scaled(char*& out, double scaled, std::string_view unit, u64 carry) {
+            static constexpr u64 scale[] = { 1, 10, 100 };
+            int decimals = scaled < 10.0 ? 2 : scaled < 100.0 ? 1 : 0;
+            auto fixed   = static_cast<u64>(std::llround(scaled * static_cast<double>(scale[decimals])));
+            if (fixed >= 1000 && decimals > 0) {
+                // 9.996 rounds to 10.00, keep three digits.
+                --decimals;
+                fixed = (fixed + 5) / 10;
+            }
+            if (decimals == 0 && carry && fixed >= carry) {
+                return false;
+            }
+            out = format_decimal(out, fixed / scale[decimals]);
+            if (decimals > 0) {
+                auto fraction = fixed % scale[decimals];
+                *out++ = '.';
+                if (decimals == 2) {
+                    std::memcpy(out, detail::digit_pairs.data() + fraction * 2, 2);
+                    out += 2;
+                } else {
+                    *out++ = static_cast<char>('0' + fraction);
+                }
+            }
+            *out++ = ' ';
+            out = put(out, unit);
+            return true;
+        }
+
+    }
+
+    auto format_grouped(char* out, i64 value, char separator) -> char* {
+        char  buffer[max_grouped_chars];
+        char* end   = buffer + sizeof(buffer);
+        // The sign goes in front of the first group, never between it and a separator.
+        char* begin = write_grouped_backward(end, value < 0 ? u64(0) - static_cast<u64>(value) : static_cast<u64>(value), separator);
+        if (value < 0) {
+            *--begin = '-';
+        }
+        std::memcpy(out, begin, static_cast<std::size_t>(end - begin));
+        return out + (end - begin);
+    }
+
+    auto format_grouped(char* out, u64 value, char separator) -> char* {
+        char  buffer[max_grouped_chars];
+        char* end   = buffer + sizeof(buffer);
+        char* begin = write_grouped_backward(end, value, separator);
+        std::memcpy(out, begin, static_cast<std::size_t>(end - begin));
+        return out + (end - begin);
+    }
+
+    auto format_bytes(char* out, u64 bytes) -> char* {
+        static constexpr std::string_view units[] = { "B", "KiB", "MiB", "GiB", "TiB", "PiB", "EiB" };
+        if (bytes < 1024) {
+            out = format_decimal(out, bytes);
+            return put(out, " B");
+        }
+        std::size_t unit   = 1;
+        double      scaled = static_cast<double>(bytes) / 1024.0;
+        while (scaled >= 1024.0 && unit + 1 < std::size(units)) {
+            scaled /= 1024.0;
+            ++unit;
+        }
+        // 1000 to 1023 of a unit are printed as they are, below the next unit. 1023.5 and up round to
+        // 1024 and carry over to 1.00 of the next one.
+        if (!put_scaled(out, scaled, units[unit], unit + 1 < std::size(units) ? 1024 : 0)) {
+            put_scaled(out, scaled / 1024.0, units[unit + 1], 0);
+        }
+        return out;
+    }
+
+    auto format_duration(char* out, std::chrono::nanoseconds duration) -> char* {
+        static constexpr std::string_view units[] = { "ns", "us", "ms", "s" };
+        auto count = duration.count();
+        if (count < 0) {
+            *out++ = '-';
+        }
+        auto ns = count < 0 ? u64(0) - static_cast<u64>(count) : static_cast<u64>(count);
+        if (ns < 1000) {
+            out = format_decimal(out, ns);
+            return put(out, " ns");
+        }
+        std::size_t unit = 1;
+        double      divisor = 1e3;
+        while (unit + 1 < std::size(units) && static_cast<double>(ns) >= divisor * 1000.0) {
+            divisor *= 1000.0;
+            ++unit;
+        }
+        // 999.7 us carries over to 1.00 ms, seconds just keep growing.
+        if (!put_scaled(out, static_cast<double>(ns) / divisor, units[unit], unit + 1 < std::size(units) ? 1000 : 0)) {
+            put_scaled(out, static_cast<double>(ns) / (divisor * 1000.0), units[unit + 1], 0);
+        }
+        return out;
+    }
+
+}
@@ -0,0 +1,321 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+namespace aby::prof {
+
+    namespace {
+
+        struct RawEvent {
+            const Zone* zone;
+            i64         begin;
+            i64         end;
+        };
+
+        // 4096 events, 96KB: one allocation per few thousand zones.
+        constexpr std::size_t block_events = 4096;
+
+        struct Block {
+            std::atomic<std::size_t> count{ 0 };       // Events published by the owner thread.
+            std::atomic<Block*>      next{ nullptr };  // Set once this block is full.
+            RawEvent                 events[block_events];
+        };
+
+        /**
+        * Single producer (the owning thread) and single consumer (capture(), under the registry lock).
+        * The producer only ever writes tail, the consumer only frees blocks the producer has moved past.
+        */
+        struct ThreadBuffer {
+            u32               id;
+            std::string       name;           // Guarded by the registry lock.
+            Block*            head;           // Consumer side.
+            std::size_t       consumed = 0;   // Events of head already taken.
+            Block*            tail;           // Producer side.
+            std::atomic<bool> bExited{ false };
+
+            explicit ThreadBuffer(u32 id) : id(id), head(new Block), tail(head) {}
+
+            ~ThreadBuffer() {
+                while (head) {
+                    delete std::exchange(head, head->next.load(std::memory_order_relaxed));
+                }
+            }
+
+            void push(const RawEvent& event) {
+                std::size_t n = tail->count.load(std::memory_order_relaxed);
+                if (n == block_events) {
+                    auto* block = new Block;
+                    tail->next.store(block, std::memory_order_release);
+                    tail = block;
+                    n = 0;
+                }
+                tail->events[n] = event;
+                tail->count.store(n + 1, std::memory_order_release);
+            }
+        };
+
+        struct Registry {
+            std::mutex                                 mutex;
+            std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+            u32                                        next_id = 1;
+        };
+
+        auto registry() -> Registry& {
+            static Registry instance;
+            return instance;
+        }
+
+        // Registers the thread on its first zone and flags the buffer on exit, so capture() can drop it.
+        struct LocalBuffer {
+            ThreadBuffer* buffer = nullptr;
+
+            auto get() -> ThreadBuffer& {
+                if (!buffer) {
+                    auto& reg = registry();
+                    std::lock_guard lock(reg.mutex);
+                    buffer = reg.buffers.emplace_back(std::make_unique<ThreadBuffer>(reg.next_id++)).get();
+                }
+                return *buffer;
+            }
+
+            ~LocalBuffer() {
+                if (buffer) {
+                    buffer->bExited.store(true, std::memory_order_release);
+                }
+            }
+        };
+
+        thread_local LocalBuffer t_Buffer;
+
+        void append_json_string(std::string& out, std::string_view str) {
+            out += '"';
+            for (char c : str) {
+                switch (c) {
+                    case '"':  out += "\\\""; break;
+                    case '\\': out += "\\\\"; break;
+                    case '\n': out += "\\n";  break;
+                    case '\t': out += "\\t";  break;
+                    default:
+                        if (static_cast<unsigned char>(c) < 0x20) {
+                            std::format_to(std::back_inserter(out), "\\u{:04x}", static_cast<unsigned>(c));
+                        } else {
+                            out += c;
+                        }
+                }
+            }
+            out += '"';
+        }
+
+        template <typename T>
+        void put(std::ofstream& os, T value) {
+            value = to_little_endian(value);
+            os.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+
+        void put_string(std::ofstream& os, std::string_view str) {
+            auto len = static_cast<u16>(std::min<std::size_t>(str.size(), UINT16_MAX));
+            put(os, len);
+            os.write(str.data(), len);
+        }
+
+        template <typename T>
+        bool get(std::ifstream& is, T& value) {
+            if (!is.read(reinterpret_cast<char*>(&value), sizeof(value))) {
+                return false;
+            }
+            value = to_little_endian(value);
+            return true;
+        }
+
+        bool get_string(std::ifstream& is, std::string& out) {
+            u16 len = 0;
+            if (!get(is, len)) {
+                return false;
+            }
+            out.resize(len);
+            return len == 0 || static_cast<bool>(is.read(out.data(), len));
+        }
+
+    }
+
+    void record(const Zone& zone, i64 begin, i64 end) {
+        t_Buffer.get().push({ &zone, begin, end });
+    }
+
+    void set_thread_name(std::string_view name) {
+        auto& buffer = t_Buffer.get();
+        std::lock_guard lock(registry().mutex);
+        buffer.name = name;
+    }
+
+    auto capture() -> Capture {
+        Capture out;
+        std::unordered_map<const Zone*, u32> zone_ids;
+        auto zone_id = [&](const Zone* zone) -> u32 {
+            auto [it, inserted] = zone_ids.try_emplace(zone, static_cast<u32>(out.zones.size()));
+            if (inserted) {
+                out.zones.push_back({ std::string(zone->name), std::string(zone->file), std::string(zone->function), zone->line });
+            }
+            return it->second;
+        };
+
+        auto& reg = registry();
+        std::lock_guard lock(reg.mutex);
+        std::erase_if(reg.buffers, [&](const std::unique_ptr<ThreadBuffer>& buffer) {
+            // Read before draining: once set, nothing more can be pushed after the drain below.
+            bool exited = buffer->bExited.load(std::memory_order_acquire);
+            Capture::Thread thread{ buffer->id, buffer->name, {} };
+            while (true) {
+                Block* block = buffer->head;
+                std::size_t count = block->count.load(std::memory_order_acquire);
+                for (std::size_t i = buffer->consumed; i < count; ++i) {
+                    const RawEvent& event = block->events[i];
+                    thread.events.push_back({ zone_id(event.zone), event.begin, event.end });
+                }
+                buffer->consumed = count;
+                // next is only set after the block filled up, so count was final when it was read.
+                Block* next = block->next.load(std::memory_order_acquire);
+                if (!next || count != block_events) {
+                    break;
+                }
+                buffer->head = next;
+                buffer->consumed = 0;
+                delete block;
+            }
+            if (!thread.events.empty()) {
+                out.threads.push_back(std::move(thread));
+            }
+            return exited;
+        });
+        return out;
+    }
+
+    auto to_chrome_trace(const Capture& capture) -> std::string {
+        i64 origin = INT64_MAX;
+        for (const auto& thread : capture.threads) {
+            for (const auto& event : thread.events) {
+                origin = std::min(origin, event.begin);
+            }
+        }
+
+        std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        auto separator = [&] {
+            if (!first) {
+                out += ',';
+            }
+            first = false;
+            out += "\n";
+        };
+        for (const auto& thread : capture.threads) {
+            if (!thread.name.empty()) {
+                separator();
+                std::format_to(std::back_inserter(out), "{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":", thread.id);
+                append_json_string(out, thread.name);
+                out += "}}";
+            }
+            for (const auto& event : thread.events) {
+                const auto& zone = capture.zones[event.zone];
+                separator();
+                out += "{\"name\":";
+                append_json_string(out, zone.name.empty() ? zone.function : zone.name);
+                std::format_to(std::back_inserter(out), ",\"cat\":\"aby\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{},\"args\":{{\"file\":",
+                    static_cast<double>(event.begin - origin) / 1000.0, static_cast<double>(event.end - event.begin) / 1000.0, thread.id);
+                append_json_string(out, zone.file);
+                std::format_to(std::back_inserter(out), ",\"line\":{},\"function\":", zone.line);
+                append_json_string(out, zone.function);
+                out += "}}";
+            }
+        }
+        out += "\n]}\n";
+        return out;
+    }
+
+    bool write_chrome_trace(const Capture& capture, const fs::path& path) {
+        std::ofstream os(path, std::ios::binary | std::ios::trunc);
+        if (!os) {
+            return false;
+        }
+        std::string json = to_chrome_trace(capture);
+        os.write(json.data(), static_cast<std::streamsize>(json.size()));
+        return static_cast<bool>(os.flush());
+    }
+
+    bool write_binary(const Capture& capture, const fs::path& path) {
+        std::ofstream os(path, std::ios::binary | std::ios::trunc);
+        if (!os) {
+            return false;
+        }
+        os.write(binprof::magic, sizeof(binprof::magic));
+        put(os, binprof::version);
+        put(os, static_cast<u32>(capture.zones.size()));
+        put(os, static_cast<u32>(capture.threads.size()));
+        for (const auto& zone : capture.zones) {
+            put(os, static_cast<u32>(zone.line));
+            put_string(os, zone.name);
+            put_string(os, zone.file);
+            put_string(os, zone.function);
+        }
+        for (const auto& thread : capture.threads) {
+            put(os, thread.id);
+            put_string(os, thread.name);
+            put(os, static_cast<u64>(thread.events.size()));
+            for (const auto& event : thread.events) {
+                put(os, event.zone);
+                put(os, event.begin);
+                put(os, event.end - event.begin);
+            }
+        }
+        return static_cast<bool>(os.flush());
+    }
+
+    bool read_binary(const fs::path& path, Capture& out) {
+        std::ifstream is(path, std::ios::binary);
+        char magic[sizeof(binprof::magic)];
+        u8   version     = 0;
+        u32  zone_count  = 0;
+        u32  thread_count = 0;
+        if (!is || !is.read(magic, sizeof(magic)) || !std::equal(std::begin(magic), std::end(magic), binprof::magic) ||
+            !get(is, version) || version != binprof::version || !get(is, zone_count) || !get(is, thread_count)) {
+            return false;
+        }
+
+        // Counts come from the file, so the vectors grow as entries are actually read: a corrupt count
+        // fails at the end of the file instead of allocating for it up front.
+        out = {};
+        for (u32 z = 0; z < zone_count; ++z) {
+            auto& zone = out.zones.emplace_back();
+            u32 line = 0;
+            if (!get(is, line) || !get_string(is, zone.name) || !get_string(is, zone.file) || !get_string(is, zone.function)) {
+                return false;
+            }
+            zone.line = static_cast<int>(line);
+        }
+        for (u32 t = 0; t < thread_count; ++t) {
+            auto& thread = out.threads.emplace_back();
+            u64 count = 0;
+            if (!get(is, thread.id) || !get_string(is, thread.name) || !get(is, count)) {
+                return false;
+            }
+            for (u64 i = 0; i < count; ++i) {
+                Capture::Event event;
+                i64 duration = 0;
+                if (!get(is, event.zone) || !get(is, event.begin) || !get(is, duration) || event.zone >= zone_count) {
+                    return false;
+                }
+                event.end = event.begin + duration;
+                thread.events.push_back(event);
+            }
+        }
+        return true;
+    }
+
+}
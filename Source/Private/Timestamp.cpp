@@ -0,0 +1,89 @@
+#include "Timestamp.h"
+#include <ctime>
+#include <format>
+
+namespace aby::log {
+
+    auto timestamp_now(ETimePrecision precision) -> std::chrono::system_clock::time_point {
+#if defined(__linux__) && defined(CLOCK_REALTIME_COARSE)
+        if (precision == ETimePrecision::SECONDS) {
+            timespec ts{};
+            clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+            return std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec)));
+        }
+#endif
+        (void)precision;
+        return std::chrono::system_clock::now();
+    }
+
+    TimestampCache::TimestampCache(ETimePrecision precision) :
+        m_Precision(precision),
+        m_Buffer{},
+        m_PrefixLen(0),
+        m_MinuteBegin(-1)
+    {}
+
+    auto TimestampCache::format(std::chrono::system_clock::time_point time) -> std::string_view {
+        using namespace std::chrono;
+        auto since_epoch = time.time_since_epoch();
+        i64  seconds     = duration_cast<std::chrono::seconds>(since_epoch).count();
+        if (since_epoch < std::chrono::seconds(seconds)) {
+            --seconds; // floor for times before the epoch
+        }
+
+        if (m_MinuteBegin < 0 || seconds < m_MinuteBegin || seconds >= m_MinuteBegin + 60) {
+            rebuild_prefix(seconds);
+        }
+
+        char* out = m_Buffer.data() + m_PrefixLen;
+        auto  sec = static_cast<int>(seconds - m_MinuteBegin);
+        *out++ = static_cast<char>('0' + sec / 10);
+        *out++ = static_cast<char>('0' + sec % 10);
+
+        if (m_Precision != ETimePrecision::SECONDS) {
+            auto sub    = duration_cast<microseconds>(since_epoch - std::chrono::seconds(seconds)).count();
+            int  digits = 6;
+            if (m_Precision == ETimePrecision::MILLISECONDS) {
+                sub   /= 1000;
+                digits = 3;
+            }
+            *out++ = '.';
+            for (int i = digits - 1; i >= 0; --i) {
+                out[i] = static_cast<char>('0' + sub % 10);
+                sub /= 10;
+            }
+            out += digits;
+        }
+
+        return std::string_view(m_Buffer.data(), static_cast<std::size_t>(out - m_Buffer.data()));
+    }
+
+    void TimestampCache::set_precision(ETimePrecision precision) {
+        m_Precision = precision;
+    }
+
+    auto TimestampCache::precision() const -> ETimePrecision {
+        return m_Precision;
+    }
+
+    void TimestampCache::rebuild_prefix(i64 epoch_seconds) {
+        std::time_t t = static_cast<std::time_t>(epoch_seconds);
+        std::tm tm{};
+#ifdef _WIN32
+        localtime_s(&tm, &t);
+#else
+        localtime_r(&t, &tm);
+#endif
+        static const char* months[] = {
+            "Jan","Feb","Mar","Apr","May","Jun",
+            "Jul","Aug","Sep","Oct","Nov","Dec"
+        };
+        auto res = std::format_to_n(m_Buffer.data(), capacity, "{:02}-{}-{:04}•{:02}:{:02}:",
+            tm.tm_mday, months[tm.tm_mon], tm.tm_year + 1900,
+            tm.tm_hour, tm.tm_min);
+        m_PrefixLen   = static_cast<std::size_t>(res.out - m_Buffer.data());
+        m_MinuteBegin = epoch_seconds - tm.tm_sec;
+    }
+
+}
@@ -0,0 +1,222 @@
+#include "sinks/BinarySink.h"
+#include <cstring>
+#include <utility>
+
+namespace aby::log {
+
+    BinarySink::BinarySink(const fs::path& path, std::size_t buffer_size, const FlushPolicy& policy) :
+        m_File(path, buffer_size, policy),
+        m_Sites(),
+        m_Entry()
+    {
+        put_header();
+    }
+
+    void BinarySink::write(const Record& record, std::string_view) {
+        i64 ticks = record.time.time_since_epoch().count();
+        u8  level = static_cast<u8>(record.level);
+
+        if (record.site && record.render) {
+            u32 id = site_id(*record.site);
+            m_Entry.clear();
+            put(binlog::EEntry::LOG);
+            put(id);
+            put(ticks);
+            put(level);
+            put(static_cast<u8>(record.args.count()));
+            put(static_cast<u16>(record.args.size()));
+            auto offset = m_Entry.size();
+            put_bytes(record.args.data(), record.args.size());
+            convert_args_byte_order(std::as_writable_bytes(std::span(m_Entry.data() + offset, record.args.size())), true);
+        } else {
+            m_Entry.clear();
+            put(binlog::EEntry::TEXT);
+            put(ticks);
+            put(level);
+            put(static_cast<u32>(record.text.size()));
+            put_bytes(record.text.data(), record.text.size());
+        }
+        m_File.write(record.level, m_Entry);
+    }
+
+    void BinarySink::flush() {
+        m_File.flush();
+    }
+
+    void BinarySink::flush_if_due(std::chrono::steady_clock::time_point now) {
+        m_File.flush_if_due(now);
+    }
+
+    auto BinarySink::io_stats() const -> IoStats {
+        return m_File.stats();
+    }
+
+    void BinarySink::put_header() {
+        m_Entry.clear();
+        put(binlog::EEntry::HEADER);
+        put_bytes(binlog::magic, sizeof(binlog::magic));
+        put(binlog::version);
+        put(static_cast<u64>(std::chrono::system_clock::period::den / std::chrono::system_clock::period::num));
+        m_File.write(ELevel::NONE, m_Entry);
+    }
+
+    auto BinarySink::site_id(const CallSite& site) -> u32 {
+        if (auto it = m_Sites.find(&site); it != m_Sites.end()) {
+            return it->second;
+        }
+
+        auto id = static_cast<u32>(m_Sites.size());
+        m_Sites.emplace(&site, id);
+
+        m_Entry.clear();
+        put(binlog::EEntry::SITE);
+        put(id);
+        put(static_cast<u8>(site.level));
+        put(static_cast<u32>(site.line));
+        put(static_cast<u16>(site.file.size()));
+        put_bytes(site.file.data(), site.file.size());
+        put(static_cast<u32>(site.fmt.size()));
+        put_bytes(site.fmt.data(), site.fmt.size());
+        m_File.write(ELevel::NONE, m_Entry);
+        return id;
+    }
+
+    template <typename T>
+    void BinarySink::put(const T& value) {
+        if constexpr (std::is_enum_v<T>) {
+            put(std::to_underlying(value));
+        } else {
+            T little = to_little_endian(value);
+            put_bytes(&little, sizeof(T));
+        }
+    }
+
+    void BinarySink::put_bytes(const void* data, std::size_t size) {
+        m_Entry.append(static_cast<const char*>(data), size);
+    }
+
+}
+
+namespace aby::log::binlog {
+
+    Reader::Reader(const fs::path& path) :
+        m_File(path, std::ios::binary),
+        m_Sites(),
+        m_TicksPerSecond(0),
+        bCorrupt(false),
+        m_Args()
+    {}
+
+    bool Reader::is_open() const {
+        return m_File.is_open();
+    }
+
+    bool Reader::corrupt() const {
+        return bCorrupt;
+    }
+
+    bool Reader::next(Entry& out) {
+        while (true) {
+            EEntry kind{};
+            if (!m_File.read(reinterpret_cast<char*>(&kind), sizeof(kind))) {
+                return false; // clean end of file
+            }
+
+            switch (kind) {
+                case EEntry::HEADER: {
+                    char magic_buf[sizeof(magic)];
+                    u16  file_version = 0;
+                    u64  ticks        = 0;
+                    if (!read(magic_buf) || std::memcmp(magic_buf, magic, sizeof(magic)) != 0 ||
+                        !read(file_version) || file_version != version || !read(ticks) || ticks == 0) {
+                        bCorrupt = true;
+                        return false;
+                    }
+                    m_TicksPerSecond = static_cast<i64>(ticks);
+                    m_Sites.clear();
+                    break;
+                }
+                case EEntry::SITE: {
+                    u32 id = 0, line = 0, fmt_len = 0;
+                    u8  level = 0;
+                    u16 file_len = 0;
+                    Site site;
+                    if (!read(id) || !read(level) || !read(line) || !read(file_len) || !read_string(site.file, file_len) ||
+                        !read(fmt_len) || !read_string(site.fmt, fmt_len)) {
+                        bCorrupt = true;
+                        return false;
+                    }
+                    site.level = static_cast<ELevel>(level);
+                    site.line  = static_cast<int>(line);
+                    m_Sites[id] = std::move(site);
+                    break;
+                }
+                case EEntry::LOG:
+                case EEntry::TEXT: {
+                    if (!m_TicksPerSecond) {
+                        bCorrupt = true; // entry before any header
+                        return false;
+                    }
+                    u32 id = 0;
+                    i64 ticks = 0;
+                    u8  level = 0;
+                    out.text.clear();
+                    out.file.clear();
+                    out.line = 0;
+                    if (kind == EEntry::LOG) {
+                        u8  count = 0;
+                        u16 len   = 0;
+                        if (!read(id) || !read(ticks) || !read(level) || !read(count) || !read(len) || !read_string(m_Args, len)) {
+                            bCorrupt = true;
+                            return false;
+                        }
+                        auto site = m_Sites.find(id);
+                        if (site == m_Sites.end()) {
+                            bCorrupt = true;
+                            return false;
+                        }
+                        auto args = std::as_writable_bytes(std::span(m_Args.data(), m_Args.size()));
+                        if (!convert_args_byte_order(args, false) || !render_dynamic(out.text, site->second.fmt, args)) {
+                            out.text = std::format("<undecodable: {}>", site->second.fmt);
+                        }
+                        out.file = site->second.file;
+                        out.line = site->second.line;
+                    } else {
+                        u32 len = 0;
+                        if (!read(ticks) || !read(level) || !read(len) || !read_string(out.text, len)) {
+                            bCorrupt = true;
+                            return false;
+                        }
+                    }
+                    out.level = static_cast<ELevel>(level);
+                    // Convert through seconds + remainder so any tick rate maps onto system_clock without overflow.
+                    auto secs = std::chrono::seconds(ticks / m_TicksPerSecond);
+                    auto rem  = std::chrono::nanoseconds((ticks % m_TicksPerSecond) * (1'000'000'000 / m_TicksPerSecond));
+                    out.time  = std::chrono::system_clock::time_point(
+                        std::chrono::duration_cast<std::chrono::system_clock::duration>(secs + rem));
+                    return true;
+                }
+                default:
+                    bCorrupt = true;
+                    return false;
+            }
+        }
+    }
+
+    template <typename T>
+    bool Reader::read(T& value) {
+        if (!m_File.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+            return false;
+        }
+        if constexpr (std::is_integral_v<T>) {
+            value = to_little_endian(value);
+        }
+        return true;
+    }
+
+    bool Reader::read_string(std::string& out, std::size_t len) {
+        out.resize(len);
+        return len == 0 || static_cast<bool>(m_File.read(out.data(), static_cast<std::streamsize>(len)));
+    }
+
+}
@@ -0,0 +1,131 @@
+#include "sinks/ConsoleSink.h"
+#ifdef _WIN32
+    #include <io.h>
+#else
+    #include <unistd.h>
+    #include <cerrno>
+#endif
+
+namespace aby::log {
+
+    namespace {
+
+        bool is_terminal(int fd) {
+#ifdef _WIN32
+            return _isatty(fd) != 0;
+#else
+            return ::isatty(fd) != 0;
+#endif
+        }
+
+    }
+
+    ConsoleSink::ConsoleSink(ELevel stderr_level, std::size_t buffer_size, const FlushPolicy& policy) :
+        m_StderrLevel(stderr_level),
+        m_Policy(policy),
+        m_Out{ 1, is_terminal(1), {}, {} },
+        m_Err{ 2, is_terminal(2), {}, {} }
+    {
+        m_Out.buffer.reserve(buffer_size);
+        m_Err.buffer.reserve(buffer_size);
+    }
+
+    ConsoleSink::~ConsoleSink() {
+        flush();
+    }
+
+    void ConsoleSink::write(const Record& record, std::string_view line) {
+        append(record.level, line);
+        end_batch();
+    }
+
+    void ConsoleSink::append(ELevel level, std::string_view lines) {
+        Stream& stream = stream_for(level);
+        if (&stream == &m_Err) {
+            flush(m_Out);
+        }
+        if (stream.buffer.size() + lines.size() > stream.buffer.capacity()) {
+            flush(stream);
+        }
+        if (lines.size() > stream.buffer.capacity()) {
+            write_all(stream, lines);
+            return;
+        }
+
+        if (stream.buffer.empty()) {
+            stream.oldest = std::chrono::steady_clock::now();
+        }
+        stream.buffer.insert(stream.buffer.end(), lines.begin(), lines.end());
+        if (static_cast<int>(level) >= static_cast<int>(m_Policy.level) ||
+            (m_Policy.bytes && stream.buffer.size() >= m_Policy.bytes)) {
+            flush(stream);
+        }
+    }
+
+    void ConsoleSink::end_batch() {
+        if (m_Out.bTerminal) {
+            flush(m_Out);
+        }
+        if (m_Err.bTerminal) {
+            flush(m_Err);
+        }
+    }
+
+    void ConsoleSink::flush() {
+        flush(m_Out);
+        flush(m_Err);
+    }
+
+    void ConsoleSink::flush_if_due(std::chrono::steady_clock::time_point now) {
+        if (!m_Policy.interval.count()) {
+            return;
+        }
+        for (Stream* stream : { &m_Out, &m_Err }) {
+            if (!stream->buffer.empty() && now - stream->oldest >= m_Policy.interval) {
+                flush(*stream);
+            }
+        }
+    }
+
+    auto ConsoleSink::io_stats() const -> IoStats {
+        return m_Stats;
+    }
+
+    auto ConsoleSink::stderr_level() const -> ELevel {
+        return m_StderrLevel;
+    }
+
+    auto ConsoleSink::stream_for(ELevel level) -> Stream& {
+        return static_cast<int>(level) >= static_cast<int>(m_StderrLevel) ? m_Err : m_Out;
+    }
+
+    void ConsoleSink::flush(Stream& stream) {
+        if (stream.buffer.empty()) {
+            return;
+        }
+        write_all(stream, std::string_view(stream.buffer.data(), stream.buffer.size()));
+        stream.buffer.clear();
+    }
+
+    void ConsoleSink::write_all(Stream& stream, std::string_view data) {
+        while (!data.empty()) {
+#ifdef _WIN32
+            auto written = ::_write(stream.fd, data.data(), static_cast<unsigned>(data.size()));
+#else
+            auto written = ::write(stream.fd, data.data(), data.size());
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+#endif
+            if (written <= 0) {
+                ++m_Stats.errors;
+                m_Stats.lost += data.size();
+                return;
+            }
+            ++m_Stats.writes;
+            m_Stats.bytes += static_cast<u64>(written);
+            data.remove_prefix(static_cast<std::size_t>(written));
+        }
+    }
+
+}
@@ -0,0 +1,478 @@
+#include "sinks/FileSink.h"
+#include "Compression.h"
+#include <algorithm>
+#include <cctype>
+#include <ctime>
+#include <optional>
+#ifndef _WIN32
+    #include <sys/uio.h>
+    #include <cerrno>
+#endif
+
+namespace aby::log {
+
+    namespace {
+
+        constexpr std::string_view archive_ext = ".lz";
+
+        // First multiple of interval since the epoch that lies after now.
+        auto next_boundary(std::chrono::system_clock::time_point now, std::chrono::seconds interval) -> std::chrono::system_clock::time_point {
+            auto since_epoch = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch());
+            return std::chrono::system_clock::time_point((since_epoch / interval + 1) * interval);
+        }
+
+        auto segment_stamp(std::chrono::system_clock::time_point now) -> std::string {
+            std::time_t t = std::chrono::system_clock::to_time_t(now);
+            std::tm tm{};
+#ifdef _WIN32
+            localtime_s(&tm, &t);
+#else
+            localtime_r(&t, &tm);
+#endif
+            char buffer[32];
+            std::size_t len = std::strftime(buffer, sizeof(buffer), "%Y%m%d-%H%M%S", &tm);
+            return std::string(buffer, len);
+        }
+
+        bool all_digits(std::string_view str) {
+            return !str.empty() && std::ranges::all_of(str, [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; });
+        }
+
+        auto to_number(std::string_view digits) -> u64 {
+            u64 value = 0;
+            for (char c : digits) {
+                value = value * 10 + static_cast<u64>(c - '0');
+            }
+            return value;
+        }
+
+        // Rotation order of a segment: its time stamp, then the "-N" suffix for same-second rotations.
+        struct SegmentKey {
+            u64 stamp = 0;
+            u64 seq   = 0;
+
+            auto operator<=>(const SegmentKey&) const = default;
+        };
+
+        // Parses "<stem>.<YYYYMMDD>-<HHMMSS>[-N]<ext>[.lz]" next to active.
+        auto parse_segment(const fs::path& active, const fs::path& candidate) -> std::optional<SegmentKey> {
+            if (candidate.parent_path() != active.parent_path()) {
+                return std::nullopt;
+            }
+            std::string name = candidate.filename().string();
+            std::string stem = active.stem().string();
+            std::string ext  = active.extension().string();
+
+            std::string_view rest(name);
+            if (rest.ends_with(archive_ext)) {
+                rest.remove_suffix(archive_ext.size());
+            }
+            if (!rest.starts_with(stem) || !rest.ends_with(ext) || rest.size() < stem.size() + ext.size() + 16) {
+                return std::nullopt;
+            }
+            rest.remove_prefix(stem.size());
+            rest.remove_suffix(ext.size());
+            auto date = rest.substr(1, 8);
+            auto time = rest.substr(10, 6);
+            if (rest[0] != '.' || rest[9] != '-' || !all_digits(date) || !all_digits(time)) {
+                return std::nullopt;
+            }
+            SegmentKey key{ to_number(date) * 1000000 + to_number(time), 0 };
+            rest.remove_prefix(16);
+            if (!rest.empty()) {
+                if (rest[0] != '-' || rest.size() > 10 || !all_digits(rest.substr(1))) {
+                    return std::nullopt;
+                }
+                key.seq = to_number(rest.substr(1));
+            }
+            return key;
+        }
+
+    }
+
+    FileSink::FileSink(const fs::path& path, std::size_t buffer_size, const FlushPolicy& policy, const RotationPolicy& rotation, RotateFn on_rotate) :
+        m_Path(path),
+        m_File(nullptr),
+        m_Buffer(),
+        m_Policy(policy),
+        m_OldestPending(),
+        m_Rotation(rotation),
+        m_OnRotate(std::move(on_rotate)),
+        m_SegmentSize(0),
+        m_NextRotation(),
+        m_LastStamp(),
+        m_StampSeq(0)
+    {
+        open();
+        m_Buffer.reserve(buffer_size);
+    }
+
+    FileSink::~FileSink() {
+        if (m_File) {
+            flush();
+            std::fclose(m_File);
+        }
+    }
+
+    void FileSink::write(ELevel level, std::string_view formatted_msg) {
+        if (!m_File) {
+            skip(formatted_msg.size());
+            return;
+        }
+
+        if (rotation_due(formatted_msg.size())) {
+            rotate();
+            if (!m_File) {
+                skip(formatted_msg.size());
+                return;
+            }
+        }
+        m_SegmentSize += formatted_msg.size();
+
+        if (m_Buffer.size() + formatted_msg.size() > m_Buffer.capacity()) {
+            flush();
+        }
+        if (formatted_msg.size() > m_Buffer.capacity()) {
+            write_through(formatted_msg);
+            return;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (m_Buffer.empty()) {
+            m_OldestPending = now;
+        }
+        m_Buffer.insert(m_Buffer.end(), formatted_msg.begin(), formatted_msg.end());
+
+        if (static_cast<int>(level) >= static_cast<int>(m_Policy.level) ||
+            (m_Policy.bytes && m_Buffer.size() >= m_Policy.bytes)) {
+            flush();
+        } else {
+            flush_if_due(now);
+        }
+    }
+
+    void FileSink::write_batch(std::span<const std::string_view> blocks, ELevel level) {
+        std::size_t total = 0;
+        for (auto block : blocks) {
+            total += block.size();
+        }
+        if (!m_File) {
+            skip(total);
+            return;
+        }
+
+        if (rotation_due(total)) {
+            rotate();
+            if (!m_File) {
+                skip(total);
+                return;
+            }
+        }
+        m_SegmentSize += total;
+
+        bool urgent = static_cast<int>(level) >= static_cast<int>(m_Policy.level);
+        std::size_t buffered = m_Buffer.size() + total;
+        if (!urgent && buffered <= m_Buffer.capacity() && (!m_Policy.bytes || buffered < m_Policy.bytes)) {
+            auto now = std::chrono::steady_clock::now();
+            if (m_Buffer.empty()) {
+                m_OldestPending = now;
+            }
+            for (auto block : blocks) {
+                m_Buffer.insert(m_Buffer.end(), block.begin(), block.end());
+            }
+            flush_if_due(now);
+            return;
+        }
+
+        write_vectored(blocks);
+        m_Buffer.clear();
+    }
+
+    void FileSink::flush() {
+        if (!m_File || m_Buffer.empty()) {
+            return;
+        }
+        write_through(std::string_view(m_Buffer.data(), m_Buffer.size()));
+        m_Buffer.clear();
+    }
+
+    void FileSink::flush_if_due(std::chrono::steady_clock::time_point now) {
+        if (m_Policy.interval.count() && !m_Buffer.empty() && now - m_OldestPending >= m_Policy.interval) {
+            flush();
+        }
+    }
+
+    bool FileSink::is_open() const {
+        return m_File != nullptr;
+    }
+
+    auto FileSink::path() const -> const fs::path& {
+        return m_Path;
+    }
+
+    auto FileSink::stats() const -> const IoStats& {
+        return m_Stats;
+    }
+
+    void FileSink::open() {
+#ifdef _WIN32
+        m_File = _wfopen(m_Path.c_str(), L"ab");
+#else
+        m_File = std::fopen(m_Path.c_str(), "ab");
+#endif
+        if (m_File) {
+            // We do our own buffering, stdio's would only add a second copy.
+            std::setvbuf(m_File, nullptr, _IONBF, 0);
+        }
+
+        std::error_code ec;
+        auto size = fs::file_size(m_Path, ec);
+        m_SegmentSize = ec ? 0 : size;
+        if (m_Rotation.interval.count()) {
+            m_NextRotation = next_boundary(std::chrono::system_clock::now(), m_Rotation.interval);
+        }
+    }
+
+    bool FileSink::rotation_due(std::size_t incoming) const {
+        if (m_Rotation.max_bytes && m_SegmentSize && m_SegmentSize + incoming > m_Rotation.max_bytes) {
+            return true;
+        }
+        return m_Rotation.interval.count() && std::chrono::system_clock::now() >= m_NextRotation;
+    }
+
+    void FileSink::rotate() {
+        flush();
+        std::fclose(m_File);
+        m_File = nullptr;
+
+        auto segment = next_segment_path();
+        std::error_code ec;
+        fs::rename(m_Path, segment, ec);
+
+        open();
+        if (ec) {
+            // Keep appending to the old file, and don't retry on every write.
+            m_SegmentSize = 0;
+            return;
+        }
+        if (m_OnRotate) {
+            m_OnRotate(segment);
+        }
+    }
+
+    auto FileSink::next_segment_path() -> fs::path {
+        auto stamp = segment_stamp(std::chrono::system_clock::now());
+        // Same-second rotations count up from the last one, so names are never reused and keep rotation order.
+        m_StampSeq   = stamp == m_LastStamp ? m_StampSeq + 1 : 0;
+        m_LastStamp  = stamp;
+
+        auto base = m_Path.stem().string() + "." + stamp;
+        auto ext  = m_Path.extension().string();
+        auto dir  = m_Path.parent_path();
+        auto taken = [](const fs::path& p) {
+            std::error_code ec;
+            return fs::exists(p, ec) || fs::exists(fs::path(p).concat(archive_ext), ec);
+        };
+        while (true) {
+            auto candidate = m_StampSeq ? dir / std::format("{}-{}{}", base, m_StampSeq, ext) : dir / (base + ext);
+            if (!taken(candidate)) {
+                return candidate;
+            }
+            ++m_StampSeq;
+        }
+    }
+
+    void FileSink::write_through(std::string_view data) {
+        auto written = std::fwrite(data.data(), 1, data.size(), m_File);
+        ++m_Stats.writes;
+        m_Stats.bytes += written;
+        if (written < data.size()) {
+            ++m_Stats.errors;
+            m_Stats.lost += data.size() - written;
+        }
+    }
+
+    void FileSink::skip(std::size_t bytes) {
+        // Nothing to write to, the file failed to open (or to reopen after a rotation).
+        ++m_Stats.errors;
+        m_Stats.lost += bytes;
+    }
+
+    void FileSink::write_vectored(std::span<const std::string_view> blocks) {
+        // Pending buffer first, then the blocks. The FILE is unbuffered, so going around stdio is safe.
+#ifdef _WIN32
+        if (!m_Buffer.empty()) {
+            write_through(std::string_view(m_Buffer.data(), m_Buffer.size()));
+        }
+        for (auto block : blocks) {
+            write_through(block);
+        }
+#else
+        static constexpr std::size_t max_iov = 64;
+        int fd = fileno(m_File);
+        iovec iov[max_iov];
+        std::size_t count = 0;
+        std::size_t next  = 0;
+        bool        first = !m_Buffer.empty();
+        std::size_t left_total = m_Buffer.size();
+        for (auto block : blocks) {
+            left_total += block.size();
+        }
+        while (first || next < blocks.size() || count) {
+            if (first && count < max_iov) {
+                iov[count++] = { m_Buffer.data(), m_Buffer.size() };
+                first = false;
+            }
+            while (next < blocks.size() && count < max_iov) {
+                if (!blocks[next].empty()) {
+                    iov[count++] = { const_cast<char*>(blocks[next].data()), blocks[next].size() };
+                }
+                ++next;
+            }
+            if (!count) {
+                break;
+            }
+
+            ssize_t written = ::writev(fd, iov, static_cast<int>(count));
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                ++m_Stats.errors;
+                m_Stats.lost += left_total;
+                return;
+            }
+            ++m_Stats.writes;
+            m_Stats.bytes += static_cast<u64>(written);
+            left_total    -= static_cast<std::size_t>(written);
+            // Drop what made it out, a short write leaves the rest at the front.
+            std::size_t done = 0;
+            auto left = static_cast<std::size_t>(written);
+            while (done < count && left >= iov[done].iov_len) {
+                left -= iov[done].iov_len;
+                ++done;
+            }
+            if (done < count) {
+                iov[done].iov_base = static_cast<char*>(iov[done].iov_base) + left;
+                iov[done].iov_len -= left;
+            }
+            std::move(iov + done, iov + count, iov);
+            count -= done;
+        }
+#endif
+    }
+
+}
+
+namespace aby::log {
+
+    SegmentArchiver::~SegmentArchiver() {
+        stop();
+    }
+
+    auto SegmentArchiver::shared() -> Ref<SegmentArchiver> {
+        static std::mutex            mutex;
+        static Weak<SegmentArchiver> instance;
+        std::scoped_lock lock(mutex);
+        auto archiver = instance.lock();
+        if (!archiver) {
+            archiver = create_ref<SegmentArchiver>();
+            instance = archiver;
+        }
+        return archiver;
+    }
+
+    void SegmentArchiver::submit(const void* owner, const fs::path& active, const fs::path& segment, const RotationPolicy& rotation, EventFn on_event) {
+        {
+            std::scoped_lock lock(m_Mutex);
+            m_Jobs.push_back(Job{ owner, active, segment, rotation, std::move(on_event) });
+            if (!m_Worker.joinable()) {
+                m_bStopping = false;
+                m_Worker = std::thread(&SegmentArchiver::run, this);
+            }
+        }
+        m_Wake.notify_one();
+    }
+
+    void SegmentArchiver::wait(const void* owner) {
+        std::unique_lock lock(m_Mutex);
+        m_Done.wait(lock, [&] { return !has_jobs_of(owner); });
+    }
+
+    bool SegmentArchiver::has_jobs_of(const void* owner) const {
+        return m_Running == owner || std::ranges::any_of(m_Jobs, [&](const Job& job) { return job.owner == owner; });
+    }
+
+    void SegmentArchiver::stop() {
+        {
+            std::scoped_lock lock(m_Mutex);
+            if (!m_Worker.joinable()) {
+                return;
+            }
+            m_bStopping = true;
+        }
+        m_Wake.notify_one();
+        m_Worker.join();
+        m_Worker = {};
+    }
+
+    void SegmentArchiver::run() {
+        while (true) {
+            Job job;
+            {
+                std::unique_lock lock(m_Mutex);
+                m_Wake.wait(lock, [this] { return m_bStopping || !m_Jobs.empty(); });
+                if (m_Jobs.empty()) {
+                    return;
+                }
+                job = std::move(m_Jobs.front());
+                m_Jobs.pop_front();
+                m_Running = job.owner;
+            }
+            process(job);
+            {
+                std::scoped_lock lock(m_Mutex);
+                m_Running = nullptr;
+            }
+            m_Done.notify_all();
+        }
+    }
+
+    void SegmentArchiver::process(const Job& job) {
+        if (job.rotation.compress) {
+            auto archive = fs::path(job.segment).concat(archive_ext);
+            if (lz::compress_file(job.segment, archive)) {
+                std::error_code ec;
+                fs::remove(job.segment, ec);
+                job.on_event(EMessageType::COMPRESSED, archive);
+            }
+        }
+        if (job.rotation.keep) {
+            enforce_retention(job);
+        }
+    }
+
+    void SegmentArchiver::enforce_retention(const Job& job) {
+        const auto& active = job.active;
+        const auto  keep   = job.rotation.keep;
+        auto dir = active.parent_path().empty() ? fs::path(".") : active.parent_path();
+        std::vector<std::pair<SegmentKey, fs::path>> segments;
+        std::error_code ec;
+        for (auto it = fs::directory_iterator(dir, ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+            auto candidate = active.parent_path() / it->path().filename();
+            if (auto key = parse_segment(active, candidate)) {
+                segments.emplace_back(*key, std::move(candidate));
+            }
+        }
+        if (segments.size() <= keep) {
+            return;
+        }
+        std::ranges::sort(segments, {}, &std::pair<SegmentKey, fs::path>::first);
+        for (std::size_t i = 0; i < segments.size() - keep; ++i) {
+            if (fs::remove(segments[i].second, ec)) {
+                job.on_event(EMessageType::REMOVED, segments[i].second);
+            }
+        }
+    }
+
+}
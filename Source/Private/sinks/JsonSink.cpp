@@ -0,0 +1,177 @@
+#include "sinks/JsonSink.h"
+#include <charconv>
+#include <cmath>
+
+namespace aby::log {
+
+    namespace {
+
+        auto level_name(ELevel level) -> std::string_view {
+            switch (level) {
+                case ELevel::TRACE:  return "TRACE";
+                case ELevel::INFO:   return "INFO";
+                case ELevel::WARN:   return "WARN";
+                case ELevel::DEBUG:  return "DEBUG";
+                case ELevel::ERROR:  return "ERROR";
+                case ELevel::ASSERT: return "ASSERT";
+                default:             return "NONE";
+            }
+        }
+
+        template <typename T>
+        void append_number(std::string& out, T value) {
+            char buffer[32];
+            auto [end, ec] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            out.append(buffer, ec == std::errc() ? end : buffer);
+        }
+
+        void append_digits(char* out, u32 value, int width) {
+            for (int i = width - 1; i >= 0; --i) {
+                out[i] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            }
+        }
+
+    }
+
+    JsonSink::JsonSink(const fs::path& path, std::size_t buffer_size, const FlushPolicy& policy) :
+        m_File(path, buffer_size, policy)
+    {}
+
+    void JsonSink::write(const Record& record, std::string_view) {
+        serialize(record);
+        m_Line += '\n';
+        m_File.write(record.level, m_Line);
+    }
+
+    void JsonSink::flush() {
+        m_File.flush();
+    }
+
+    void JsonSink::flush_if_due(std::chrono::steady_clock::time_point now) {
+        m_File.flush_if_due(now);
+    }
+
+    auto JsonSink::io_stats() const -> IoStats {
+        return m_File.stats();
+    }
+
+    auto JsonSink::serialize(const Record& record) -> std::string_view {
+        std::string_view text = record.text;
+        if (record.render) {
+            m_Text.clear();
+            record.render(m_Text, record.site->fmt, record.args);
+            text = m_Text;
+        }
+
+        m_Line.clear();
+        m_Line += "{\"ts\":\"";
+        put_time(record.time);
+        m_Line += "\",\"level\":\"";
+        m_Line += level_name(record.level);
+        m_Line += "\",\"msg\":";
+        put_string(text);
+        if (record.site) {
+            m_Line += ",\"file\":";
+            put_string(record.site->file);
+            m_Line += ",\"line\":";
+            append_decimal(m_Line, record.site->line);
+        }
+        // Nested, so a field called "level" or "msg" can't shadow the record's own keys.
+        if (!record.fields.empty()) {
+            m_Line += ",\"fields\":{";
+            bool first = true;
+            for (const auto& field : record.fields) {
+                if (!first) {
+                    m_Line += ',';
+                }
+                first = false;
+                put_string(field.key);
+                m_Line += ':';
+                put_value(field.value);
+            }
+            m_Line += '}';
+        }
+        if (auto dropped = record.fields.dropped()) {
+            m_Line += ",\"fields_dropped\":";
+            append_decimal(m_Line, dropped);
+        }
+        m_Line += '}';
+        return m_Line;
+    }
+
+    void JsonSink::put_time(std::chrono::system_clock::time_point time) {
+        using namespace std::chrono;
+        auto us      = floor<microseconds>(time);
+        auto seconds = floor<std::chrono::seconds>(us);
+        if (seconds.time_since_epoch().count() != m_CachedSecond) {
+            m_CachedSecond = seconds.time_since_epoch().count();
+            auto days = floor<std::chrono::days>(seconds);
+            year_month_day date(days);
+            hh_mm_ss clock(seconds - days);
+            char* p = m_CachedPrefix;
+            append_digits(p, static_cast<u32>(static_cast<int>(date.year())), 4);
+            p[4] = '-';
+            append_digits(p + 5, static_cast<unsigned>(date.month()), 2);
+            p[7] = '-';
+            append_digits(p + 8, static_cast<unsigned>(date.day()), 2);
+            p[10] = 'T';
+            append_digits(p + 11, static_cast<u32>(clock.hours().count()), 2);
+            p[13] = ':';
+            append_digits(p + 14, static_cast<u32>(clock.minutes().count()), 2);
+            p[16] = ':';
+            append_digits(p + 17, static_cast<u32>(clock.seconds().count()), 2);
+            p[19] = '.';
+        }
+        char fraction[7];
+        append_digits(fraction, static_cast<u32>((us - seconds).count()), 6);
+        fraction[6] = 'Z';
+        m_Line.append(m_CachedPrefix, sizeof(m_CachedPrefix));
+        m_Line.append(fraction, sizeof(fraction));
+    }
+
+    void JsonSink::put_string(std::string_view str) {
+        static constexpr char hex[] = "0123456789abcdef";
+        m_Line += '"';
+        std::size_t run = 0; // Start of the pending stretch that needs no escaping.
+        for (std::size_t i = 0; i < str.size(); ++i) {
+            auto c = static_cast<unsigned char>(str[i]);
+            if (c >= 0x20 && c != '"' && c != '\\') {
+                continue;
+            }
+            m_Line.append(str.data() + run, i - run);
+            run = i + 1;
+            switch (c) {
+                case '"':  m_Line += "\\\""; break;
+                case '\\': m_Line += "\\\\"; break;
+                case '\n': m_Line += "\\n";  break;
+                case '\r': m_Line += "\\r";  break;
+                case '\t': m_Line += "\\t";  break;
+                default: {
+                    char escape[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+                    m_Line.append(escape, sizeof(escape));
+                }
+            }
+        }
+        m_Line.append(str.data() + run, str.size() - run);
+        m_Line += '"';
+    }
+
+    void JsonSink::put_value(const FieldValue& value) {
+        std::visit([this](const auto& v) {
+            using V = std::remove_cvref_t<decltype(v)>;
+            if constexpr (std::is_same_v<V, bool>) {
+                m_Line += v ? "true" : "false";
+            } else if constexpr (std::is_same_v<V, std::string_view>) {
+                put_string(v);
+            } else if constexpr (std::is_same_v<V, double>) {
+                // JSON has no NaN/Infinity.
+                if (std::isfinite(v)) append_number(m_Line, v);
+                else                  m_Line += "null";
+            } else {
+                append_decimal(m_Line, v);
+            }
+        }, value);
+    }
+
+}
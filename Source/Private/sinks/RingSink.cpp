@@ -0,0 +1,153 @@
+#include "sinks/RingSink.h"
+#include <atomic>
+#include <cstring>
+
+namespace aby::log {
+
+    namespace {
+
+        // Copy size bytes starting at ring position pos out of a ring of the given capacity.
+        void copy_out(const std::byte* data, u64 capacity, u64 pos, void* dst, std::size_t size) {
+            auto offset = static_cast<std::size_t>(pos % capacity);
+            auto first  = std::min<std::size_t>(size, static_cast<std::size_t>(capacity) - offset);
+            std::memcpy(dst, data + offset, first);
+            std::memcpy(static_cast<std::byte*>(dst) + first, data, size - first);
+        }
+
+    }
+
+    RingSink::RingSink(const fs::path& path, std::size_t capacity) :
+        m_File(),
+        m_Header(nullptr),
+        m_Data(nullptr),
+        m_Capacity(capacity)
+    {
+        // Room for a length prefix and at least one byte of text, or the sink stays closed.
+        if (capacity <= sizeof(u32) || !m_File.open(path, MappedFile::EMode::READ_WRITE, sizeof(ringlog::Header) + capacity)) {
+            return;
+        }
+        m_Header = reinterpret_cast<ringlog::Header*>(m_File.data());
+        m_Data   = m_File.data() + sizeof(ringlog::Header);
+
+        bool reuse = std::memcmp(m_Header->magic, ringlog::magic, sizeof(ringlog::magic)) == 0 &&
+                     m_Header->version == ringlog::version &&
+                     m_Header->header_size == sizeof(ringlog::Header) &&
+                     m_Header->capacity == capacity &&
+                     m_Header->tail <= m_Header->head && m_Header->head - m_Header->tail <= capacity;
+        if (!reuse) {
+            std::memset(m_Header, 0, sizeof(ringlog::Header));
+            std::memcpy(m_Header->magic, ringlog::magic, sizeof(ringlog::magic));
+            m_Header->version     = ringlog::version;
+            m_Header->header_size = sizeof(ringlog::Header);
+            m_Header->capacity    = capacity;
+        }
+    }
+
+    void RingSink::write(const Record&, std::string_view line) {
+        if (!m_Header || line.empty()) {
+            return;
+        }
+
+        // A single line larger than the ring keeps its beginning.
+        auto len  = static_cast<u32>(std::min<u64>(line.size(), m_Capacity - sizeof(u32)));
+        u64  need = sizeof(u32) + len;
+
+        std::atomic_ref<u64> head_ref(m_Header->head);
+        std::atomic_ref<u64> tail_ref(m_Header->tail);
+        u64 head = head_ref.load(std::memory_order_relaxed);
+        u64 tail = tail_ref.load(std::memory_order_relaxed);
+
+        // Retire the oldest records before their bytes get overwritten, so [tail, head) stays readable
+        // at every point a crash could interrupt us.
+        while (head + need - tail > m_Capacity) {
+            tail += sizeof(u32) + length_at(tail);
+        }
+        tail_ref.store(tail, std::memory_order_release);
+
+        copy_in(head, &len, sizeof(len));
+        copy_in(head + sizeof(u32), line.data(), len);
+        head_ref.store(head + need, std::memory_order_release);
+    }
+
+    void RingSink::flush() {
+        if (m_Header) {
+            m_File.sync();
+        }
+    }
+
+    bool RingSink::is_open() const {
+        return m_Header != nullptr;
+    }
+
+    void RingSink::copy_in(u64 pos, const void* src, std::size_t size) {
+        auto offset = static_cast<std::size_t>(pos % m_Capacity);
+        auto first  = std::min<std::size_t>(size, static_cast<std::size_t>(m_Capacity) - offset);
+        std::memcpy(m_Data + offset, src, first);
+        std::memcpy(m_Data, static_cast<const std::byte*>(src) + first, size - first);
+    }
+
+    auto RingSink::length_at(u64 pos) const -> u32 {
+        u32 len = 0;
+        copy_out(m_Data, m_Capacity, pos, &len, sizeof(len));
+        return len;
+    }
+
+}
+
+namespace aby::log::ringlog {
+
+    Reader::Reader(const fs::path& path) :
+        m_File(),
+        m_Capacity(0),
+        m_Pos(0),
+        m_End(0),
+        bCorrupt(false)
+    {
+        if (!m_File.open(path, MappedFile::EMode::READ) || m_File.size() < sizeof(Header)) {
+            m_File.close();
+            return;
+        }
+        Header header;
+        std::memcpy(&header, m_File.data(), sizeof(header));
+        if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != version ||
+            header.header_size != sizeof(Header) || header.capacity == 0 ||
+            m_File.size() < sizeof(Header) + header.capacity ||
+            header.tail > header.head || header.head - header.tail > header.capacity) {
+            m_File.close();
+            return;
+        }
+        m_Capacity = header.capacity;
+        m_Pos      = header.tail;
+        m_End      = header.head;
+    }
+
+    bool Reader::is_open() const {
+        return m_File.is_open();
+    }
+
+    bool Reader::corrupt() const {
+        return bCorrupt;
+    }
+
+    bool Reader::next(std::string& line) {
+        if (!m_File.is_open() || m_Pos >= m_End) {
+            return false;
+        }
+        const std::byte* data = m_File.data() + sizeof(Header);
+        u32 len = 0;
+        if (m_End - m_Pos < sizeof(len)) {
+            bCorrupt = true;
+            return false;
+        }
+        copy_out(data, m_Capacity, m_Pos, &len, sizeof(len));
+        if (m_End - m_Pos - sizeof(len) < len) {
+            bCorrupt = true;
+            return false;
+        }
+        line.resize(len);
+        copy_out(data, m_Capacity, m_Pos + sizeof(len), line.data(), len);
+        m_Pos += sizeof(len) + len;
+        return true;
+    }
+
+}
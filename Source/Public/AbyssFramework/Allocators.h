@@ -0,0 +1,145 @@
+#pragma once
+
+#include "Types.h"
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+namespace aby {
+
+    /*
+    * Memory resources for short-lived, allocation heavy structures (BiMaps, node based containers).
+    * Both are std::pmr::memory_resources, so they plug into std::pmr containers, pmr::BiMap and the
+    * create_ref/create_unique overloads below. Neither locks: use one per thread (or per structure
+    * owned by one thread), that's what keeps allocation thread-local and cheap.
+    */
+
+    /**
+    * @brief Monotonic arena: allocation bumps a pointer inside large chunks, deallocation is a no-op.
+    *        reset() rewinds over the chunks it already has, release() gives them back upstream;
+    *        both cost one step per chunk, not per allocation.
+    */
+    class Arena : public std::pmr::memory_resource {
+    public:
+        explicit Arena(std::size_t chunk_size = 64 * 1024, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+        ~Arena() override;
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        // Everything allocated so far is gone, the chunks are kept for the next round.
+        void reset();
+        // Everything allocated so far is gone, the chunks go back upstream.
+        void release();
+
+        /**
+        * @brief Construct a T in the arena whose destructor is never run: it ends with reset()/release().
+        *        Meant for structures whose destructor would only hand memory back to this arena
+        *        (e.g. a pmr::BiMap of trivially destructible or pmr types built on it), so tearing
+        *        them down costs nothing.
+        */
+        template <typename T, typename... Args>
+        auto make(Args&&... args) -> T* {
+            return ::new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        }
+
+        auto used() const -> std::size_t { return m_Used; }         // Bytes handed out since the last reset.
+        auto reserved() const -> std::size_t { return m_Reserved; } // Bytes held in chunks.
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void*, std::size_t, std::size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    private:
+        struct Chunk;
+
+        void next_chunk(std::size_t bytes, std::size_t alignment);
+    private:
+        std::pmr::memory_resource* m_Upstream;
+        std::size_t                m_ChunkSize;
+        Chunk*                     m_Head     = nullptr; // Chunks in the order they are filled.
+        Chunk*                     m_Current  = nullptr;
+        std::byte*                 m_Cursor   = nullptr;
+        std::byte*                 m_End      = nullptr;
+        std::size_t                m_Used     = 0;
+        std::size_t                m_Reserved = 0;
+    };
+
+    /**
+    * @brief Pool of fixed-size blocks with a free list, for node based containers (std::map/BiMap
+    *        nodes, list nodes): allocate and deallocate are a pointer pop/push. Requests larger than
+    *        block_size (or more aligned than max_align_t) go upstream unchanged.
+    *        release() frees all chunks at once, blocks still in use included.
+    */
+    class NodePool : public std::pmr::memory_resource {
+    public:
+        explicit NodePool(std::size_t block_size = 128, std::size_t blocks_per_chunk = 256,
+                          std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+        ~NodePool() override;
+
+        NodePool(const NodePool&) = delete;
+        NodePool& operator=(const NodePool&) = delete;
+
+        void release();
+
+        auto block_size() const -> std::size_t { return m_BlockSize; }
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    private:
+        struct Block { Block* next; };
+        struct Chunk;
+
+        bool pooled(std::size_t bytes, std::size_t alignment) const {
+            return bytes <= m_BlockSize && alignment <= alignof(std::max_align_t);
+        }
+    private:
+        std::pmr::memory_resource* m_Upstream;
+        std::size_t                m_BlockSize;
+        std::size_t                m_BlocksPerChunk;
+        Chunk*                     m_Chunks = nullptr;
+        Block*                     m_Free   = nullptr;
+    };
+
+    /**
+    * @brief Deleter for create_unique(resource, ...): destroys and hands the memory back to the resource.
+    */
+    template <typename T>
+    struct ResourceDeleter {
+        std::pmr::memory_resource* resource = nullptr;
+
+        void operator()(T* ptr) const {
+            ptr->~T();
+            resource->deallocate(ptr, sizeof(T), alignof(T));
+        }
+    };
+
+    template <typename R>
+    concept CMemoryResource = std::derived_from<R, std::pmr::memory_resource>;
+
+    /*
+    * create_ref/create_unique from a memory resource (Arena, NodePool, any std::pmr resource).
+    * A resource as first argument always selects these, it is never forwarded to T's constructor.
+    */
+
+    // Object and control block both come from resource, which must outlive the last reference.
+    template <typename T, CMemoryResource R, typename... Args>
+    Ref<T> create_ref(R& resource, Args&&... args) {
+        return std::allocate_shared<T>(std::pmr::polymorphic_allocator<T>(&resource), std::forward<Args>(args)...);
+    }
+
+    template <typename T, CMemoryResource R, typename... Args>
+    Unique<T, ResourceDeleter<T>> create_unique(R& resource, Args&&... args) {
+        void* memory = resource.allocate(sizeof(T), alignof(T));
+        try {
+            return Unique<T, ResourceDeleter<T>>(::new (memory) T(std::forward<Args>(args)...), ResourceDeleter<T>{ &resource });
+        } catch (...) {
+            resource.deallocate(memory, sizeof(T), alignof(T));
+            throw;
+        }
+    }
+
+}
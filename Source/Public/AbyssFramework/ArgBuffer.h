@@ -0,0 +1,312 @@
+#pragma once
+
+#include "Types.h"
+#include "NumberFormat.h"
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <format>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <variant>
+
+namespace aby::log {
+
+    /**
+    * @brief Wire type of a captured log argument.
+    *        Integers and floats are widened to the listed width, so every tag has a fixed payload
+    *        size (STRING is a u32 length followed by the bytes).
+    */
+    enum class EArgType : u8 {
+        BOOL,
+        CHAR,
+        I32,
+        U32,
+        I64,
+        U64,
+        F32,
+        F64,
+        STRING,
+        POINTER,
+    };
+
+    template <typename T>
+    concept CStringArg = std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> ||
+                         std::is_same_v<T, const char*> || std::is_same_v<T, char*>;
+
+    template <typename T>
+    concept CIntegerArg = std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char> &&
+                          !std::is_same_v<T, wchar_t> && !std::is_same_v<T, char8_t> &&
+                          !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t>;
+
+    template <typename T>
+    concept CPointerArg = std::is_same_v<T, const void*> || std::is_same_v<T, void*> || std::is_same_v<T, std::nullptr_t>;
+
+    /**
+    * @brief Argument types that can be captured as raw bytes and formatted later.
+    *        Anything else makes the call site fall back to formatting on the caller thread.
+    */
+    template <typename T>
+    concept CDeferredArg = std::is_same_v<T, bool> || std::is_same_v<T, char> || CIntegerArg<T> ||
+                           std::is_same_v<T, float> || std::is_same_v<T, double> ||
+                           CPointerArg<T> || CStringArg<T>;
+
+    template <typename T>
+    constexpr EArgType arg_type() {
+        if constexpr (std::is_same_v<T, bool>)             return EArgType::BOOL;
+        else if constexpr (std::is_same_v<T, char>)        return EArgType::CHAR;
+        else if constexpr (CIntegerArg<T>) {
+            if constexpr (sizeof(T) <= 4) return std::is_signed_v<T> ? EArgType::I32 : EArgType::U32;
+            else                          return std::is_signed_v<T> ? EArgType::I64 : EArgType::U64;
+        }
+        else if constexpr (std::is_same_v<T, float>)       return EArgType::F32;
+        else if constexpr (std::is_same_v<T, double>)      return EArgType::F64;
+        else if constexpr (CPointerArg<T>)                 return EArgType::POINTER;
+        else                                               return EArgType::STRING;
+    }
+
+    // Type handed to std::format when the argument is rendered.
+    template <typename T>
+    using decoded_arg_t = std::conditional_t<CStringArg<T>, std::string_view, std::conditional_t<CPointerArg<T>, const void*, T>>;
+
+    /**
+    * @brief Fixed-capacity inline storage for captured log arguments.
+    *        Lives inside the Record so capturing never touches the heap. Copies only move the used bytes.
+    *        Layout per argument: EArgType tag, then the payload.
+    */
+    class ArgBuffer {
+    public:
+        static constexpr std::size_t capacity = 256;
+
+        ArgBuffer() = default;
+        ArgBuffer(const ArgBuffer& other) : m_Size(other.m_Size), m_Count(other.m_Count) {
+            std::memcpy(m_Data.data(), other.m_Data.data(), m_Size);
+        }
+        ArgBuffer& operator=(const ArgBuffer& other) {
+            m_Size  = other.m_Size;
+            m_Count = other.m_Count;
+            std::memcpy(m_Data.data(), other.m_Data.data(), m_Size);
+            return *this;
+        }
+
+        /**
+        * @brief  Replace the contents with the given arguments.
+        * @return False if they don't fit, the buffer is left empty in that case.
+        */
+        template <typename... Args>
+        bool encode(const Args&... args) {
+            clear();
+            if ((put<std::decay_t<const Args>>(args) && ...)) {
+                return true;
+            }
+            clear();
+            return false;
+        }
+
+        void clear() { m_Size = 0; m_Count = 0; }
+
+        auto data() const -> const std::byte* { return m_Data.data(); }
+        auto size() const -> std::size_t { return m_Size; }
+        auto bytes() const -> std::span<const std::byte> { return { m_Data.data(), m_Size }; }
+        auto count() const -> std::size_t { return m_Count; }
+        bool empty() const { return m_Count == 0; }
+    private:
+        bool append(const void* src, std::size_t bytes) {
+            if (m_Size + bytes > capacity) {
+                return false;
+            }
+            std::memcpy(m_Data.data() + m_Size, src, bytes);
+            m_Size += static_cast<u16>(bytes);
+            return true;
+        }
+
+        template <typename T>
+        bool put(const T& value) {
+            constexpr EArgType type = arg_type<T>();
+            if (!append(&type, sizeof(type))) {
+                return false;
+            }
+            bool ok = false;
+            if constexpr (CStringArg<T>) {
+                std::string_view str;
+                if constexpr (std::is_pointer_v<T>) str = value ? std::string_view(value) : std::string_view("(null)");
+                else                                str = value;
+                auto len = static_cast<u32>(str.size());
+                ok = append(&len, sizeof(len)) && append(str.data(), str.size());
+            } else if constexpr (type == EArgType::I32) { i32 v = value; ok = append(&v, sizeof(v)); }
+            else if constexpr (type == EArgType::U32)   { u32 v = value; ok = append(&v, sizeof(v)); }
+            else if constexpr (type == EArgType::I64)   { i64 v = value; ok = append(&v, sizeof(v)); }
+            else if constexpr (type == EArgType::U64)   { u64 v = value; ok = append(&v, sizeof(v)); }
+            else if constexpr (type == EArgType::POINTER) {
+                auto v = static_cast<u64>(reinterpret_cast<std::uintptr_t>(static_cast<const void*>(value)));
+                ok = append(&v, sizeof(v));
+            } else {
+                ok = append(&value, sizeof(value));
+            }
+            m_Count += ok ? 1 : 0;
+            return ok;
+        }
+    private:
+        std::array<std::byte, capacity> m_Data;
+        u16                             m_Size  = 0;
+        u8                              m_Count = 0;
+    };
+
+    /**
+    * @brief Sequential reader over an ArgBuffer, the caller knows the types in order.
+    */
+    class ArgReader {
+    public:
+        explicit ArgReader(const ArgBuffer& args) : m_Cursor(args.data()) {}
+
+        template <typename T>
+        auto read() -> decoded_arg_t<T> {
+            m_Cursor += sizeof(EArgType);
+            constexpr EArgType type = arg_type<T>();
+            if constexpr (CStringArg<T>) {
+                u32 len = take<u32>();
+                std::string_view str(reinterpret_cast<const char*>(m_Cursor), len);
+                m_Cursor += len;
+                return str;
+            } else if constexpr (type == EArgType::I32) { return static_cast<T>(take<i32>()); }
+            else if constexpr (type == EArgType::U32)   { return static_cast<T>(take<u32>()); }
+            else if constexpr (type == EArgType::I64)   { return static_cast<T>(take<i64>()); }
+            else if constexpr (type == EArgType::U64)   { return static_cast<T>(take<u64>()); }
+            else if constexpr (type == EArgType::POINTER) {
+                return reinterpret_cast<const void*>(static_cast<std::uintptr_t>(take<u64>()));
+            } else {
+                return take<T>();
+            }
+        }
+    private:
+        template <typename T>
+        T take() {
+            T value;
+            std::memcpy(&value, m_Cursor, sizeof(T));
+            m_Cursor += sizeof(T);
+            return value;
+        }
+    private:
+        const std::byte* m_Cursor;
+    };
+
+    // Appends fmt rendered with captured args to out. Instantiated per call-site argument list.
+    using RenderFn = void(*)(std::string& out, std::string_view fmt, const ArgBuffer& args);
+
+    // One argument of render_plain(): integers through the NumberFormat kernels, strings copied, the rest std::format.
+    template <typename T>
+    void append_plain(std::string& out, const T& value) {
+        if constexpr (CIntegerArg<T>)                           append_decimal(out, value);
+        else if constexpr (std::is_same_v<T, std::string_view>) out.append(value);
+        else                                                    std::format_to(std::back_inserter(out), "{}", value);
+    }
+
+    /**
+    * @brief  Append fmt rendered with values if all its replacement fields are a bare "{}", which
+    *         covers most log calls. Saves std::vformat's type erasure and integer formatting.
+    * @return False, leaving out as it was, for anything else (format specs, explicit indices).
+    */
+    template <typename... Ts>
+    bool render_plain(std::string& out, std::string_view fmt, const Ts&... values) {
+        const auto  start = out.size();
+        std::size_t next  = 0; // Argument the next "{}" takes.
+        std::size_t pos   = 0;
+        while (true) {
+            auto brace = fmt.find_first_of("{}", pos);
+            if (brace == std::string_view::npos) {
+                out.append(fmt.substr(pos));
+                return true;
+            }
+            bool escaped = brace + 1 < fmt.size() && fmt[brace + 1] == fmt[brace];
+            if (escaped) {
+                out.append(fmt.substr(pos, brace + 1 - pos));
+            } else if (fmt[brace] == '{' && brace + 1 < fmt.size() && fmt[brace + 1] == '}' && next < sizeof...(Ts)) {
+                out.append(fmt.substr(pos, brace - pos));
+                [[maybe_unused]] std::size_t i = 0;
+                ((i++ == next ? append_plain(out, values) : void()), ...);
+                ++next;
+            } else {
+                out.resize(start);
+                return false;
+            }
+            pos = brace + 2;
+        }
+    }
+
+    template <typename... Args>
+    void render_args(std::string& out, std::string_view fmt, const ArgBuffer& args) {
+        ArgReader reader(args);
+        // Braced init keeps the reads in argument order.
+        std::tuple<decoded_arg_t<Args>...> values{ reader.read<Args>()... };
+        std::apply([&](auto&... v) {
+            if (!render_plain(out, fmt, v...)) {
+                std::vformat_to(std::back_inserter(out), fmt, std::make_format_args(v...));
+            }
+        }, values);
+    }
+
+    /**
+    * @brief A captured argument decoded from its EArgType tag alone, for readers that
+    *        don't have the call site's C++ types (e.g. the offline binary log decoder).
+    */
+    struct ArgValue {
+        std::variant<bool, char, i32, u32, i64, u64, float, double, std::string_view, const void*> value;
+    };
+
+    // Most arguments render_dynamic() will pass to std::format, the rest are ignored.
+    inline constexpr std::size_t max_dynamic_args = 16;
+
+    /**
+    * @brief  Decode an ArgBuffer byte range into out.
+    * @return Number of arguments in data (may exceed out.size(), extras are skipped), or size_t(-1) if malformed.
+    */
+    auto decode_args(std::span<const std::byte> data, std::span<ArgValue> out) -> std::size_t;
+
+    /**
+    * @brief Append fmt rendered with tag-decoded arguments to out.
+    *        Dynamic width/precision ("{:{}}") is not supported here, the typed path handles it.
+    * @return False if the bytes were malformed or the format was rejected.
+    */
+    bool render_dynamic(std::string& out, std::string_view fmt, std::span<const std::byte> data);
+
+    /**
+    * @brief  Convert the payloads of an ArgBuffer byte range in place, from native to little-endian order
+    *         (to_little = true, for writing a file) or back (false, after reading one). No-op on little-endian hosts.
+    * @return False if the bytes were malformed.
+    */
+    bool convert_args_byte_order(std::span<std::byte> data, bool to_little);
+
+}
+
+template <>
+struct std::formatter<aby::log::ArgValue> {
+    // Spec text including the closing brace, replayed into the real formatter once the type is known.
+    std::string_view spec;
+
+    constexpr auto parse(std::format_parse_context& ctx) {
+        auto it = ctx.begin();
+        while (it != ctx.end() && *it != '}') {
+            ++it;
+        }
+        spec = std::string_view(ctx.begin(), it == ctx.end() ? it : it + 1);
+        return it;
+    }
+
+    template <typename FormatContext>
+    auto format(const aby::log::ArgValue& arg, FormatContext& ctx) const {
+        return std::visit([&](const auto& value) { return format_as(value, ctx); }, arg.value);
+    }
+
+private:
+    template <typename T, typename FormatContext>
+    auto format_as(const T& value, FormatContext& ctx) const {
+        std::formatter<T> inner;
+        std::format_parse_context pc(spec);
+        pc.advance_to(inner.parse(pc));
+        return inner.format(value, ctx);
+    }
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Types.h"
+#include <cstdio>
+#include <span>
+#include <vector>
+
+namespace aby::lz {
+
+    /**
+    * @brief Small built-in LZ77 codec (LZ4-style token stream, no entropy stage) used to pack
+    *        rotated log segments. Favors speed and zero dependencies over ratio, which for
+    *        repetitive log text is still typically 4-8x.
+    *
+    *        File framing: "ABYLZ1", then blocks of [u32 raw size][u32 packed size][packed bytes],
+    *        ended by a u32 0. Sizes are little endian. Blocks are compressed independently, at most
+    *        block_size raw bytes each.
+    */
+    inline constexpr std::size_t block_size = 1024 * 1024;
+
+    // Most bytes compress_block() writes for raw input bytes: all literals, one length byte per 255 of them.
+    constexpr auto max_compressed_size(std::size_t raw) -> std::size_t {
+        return raw + raw / 255 + 16;
+    }
+
+    // Append the compressed form of src to dst.
+    void compress_block(std::span<const std::byte> src, std::vector<std::byte>& dst);
+    // Decode src into exactly dst.size() bytes. False if src is malformed.
+    bool decompress_block(std::span<const std::byte> src, std::span<std::byte> dst);
+
+    bool compress_file(const fs::path& src, const fs::path& dst);
+    bool decompress_file(const fs::path& src, std::FILE* dst);
+
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "Types.h"
+#include <array>
+#include <concepts>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace aby::log {
+
+    /**
+    * @brief Value of a structured log field. Integers keep their signedness at 64 bits, floats
+    *        become double, string-likes are viewed (and copied into the record when captured).
+    */
+    using FieldValue = std::variant<bool, i64, u64, double, std::string_view>;
+
+    enum class EFieldType : u8 {
+        BOOL,
+        I64,
+        U64,
+        F64,
+        STRING,
+    };
+
+    /**
+    * @brief A key/value pair at a log_*_kv call site, e.g. { "user", name }.
+    *        Only views: it lives for the logging call, the record keeps a copy of the bytes.
+    */
+    struct Field {
+        std::string_view key;
+        FieldValue       value;
+
+        Field() = default;
+
+        template <typename T>
+            requires(std::is_same_v<std::remove_cvref_t<T>, FieldValue>)
+        Field(std::string_view key, T&& value) : key(key), value(std::forward<T>(value)) {}
+
+        template <typename T>
+            requires(std::is_same_v<std::remove_cvref_t<T>, bool>)
+        Field(std::string_view key, T value) : key(key), value(static_cast<bool>(value)) {}
+
+        template <std::integral T>
+            requires(!std::is_same_v<T, bool>)
+        Field(std::string_view key, T value) : key(key) {
+            if constexpr (std::is_signed_v<T>) this->value = static_cast<i64>(value);
+            else                               this->value = static_cast<u64>(value);
+        }
+
+        template <std::floating_point T>
+        Field(std::string_view key, T value) : key(key), value(static_cast<double>(value)) {}
+
+        template <typename T>
+            requires(std::is_convertible_v<const T&, std::string_view> && !std::is_same_v<std::remove_cvref_t<T>, FieldValue>)
+        Field(std::string_view key, const T& value) : key(key), value(std::string_view(value)) {}
+    };
+
+    /**
+    * @brief Fixed-capacity inline storage for the fields of one record, like ArgBuffer: capturing
+    *        never touches the heap and copies only move the used bytes.
+    *        Layout per field: u8 key length, key, EFieldType tag, payload (8 bytes, or a u32 length
+    *        and the bytes for STRING). Fields that don't fit are dropped, see dropped().
+    */
+    class FieldBuffer {
+    public:
+        static constexpr std::size_t capacity = 192;
+
+        FieldBuffer() = default;
+        FieldBuffer(const FieldBuffer& other) : m_Size(other.m_Size), m_Count(other.m_Count), m_Dropped(other.m_Dropped) {
+            std::memcpy(m_Data.data(), other.m_Data.data(), m_Size);
+        }
+        FieldBuffer& operator=(const FieldBuffer& other) {
+            m_Size    = other.m_Size;
+            m_Count   = other.m_Count;
+            m_Dropped = other.m_Dropped;
+            std::memcpy(m_Data.data(), other.m_Data.data(), m_Size);
+            return *this;
+        }
+
+        // Replace the contents with fields, as many as fit.
+        void encode(std::initializer_list<Field> fields) {
+            clear();
+            for (const auto& field : fields) {
+                add(field);
+            }
+        }
+
+        // False if the field doesn't fit (or its key is longer than 255 bytes), it is counted as dropped then.
+        bool add(const Field& field);
+        // Replace the contents with bytes() of another buffer, false if they don't fit.
+        bool assign(std::span<const std::byte> bytes, std::size_t count);
+
+        void clear() { m_Size = 0; m_Count = 0; m_Dropped = 0; }
+
+        auto bytes() const -> std::span<const std::byte> { return { m_Data.data(), m_Size }; }
+        auto count() const -> std::size_t { return m_Count; }
+        auto dropped() const -> std::size_t { return m_Dropped; }
+        bool empty() const { return m_Count == 0; }
+
+        class Iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = Field;
+            using difference_type   = std::ptrdiff_t;
+
+            Iterator() = default;
+            Iterator(const std::byte* pos, const std::byte* end) : m_Pos(pos), m_End(end) { decode(); }
+
+            auto operator*() const -> const Field& { return m_Field; }
+            auto operator->() const -> const Field* { return &m_Field; }
+            Iterator& operator++() { m_Pos = m_Next; decode(); return *this; }
+            Iterator operator++(int) { Iterator it = *this; ++*this; return it; }
+            bool operator==(const Iterator& other) const { return m_Pos == other.m_Pos; }
+        private:
+            void decode();
+        private:
+            const std::byte* m_Pos  = nullptr;
+            const std::byte* m_End  = nullptr;
+            const std::byte* m_Next = nullptr;
+            Field            m_Field;
+        };
+
+        auto begin() const -> Iterator { return Iterator(m_Data.data(), m_Data.data() + m_Size); }
+        auto end() const -> Iterator { return Iterator(m_Data.data() + m_Size, m_Data.data() + m_Size); }
+
+        // First field called key.
+        auto find(std::string_view key) const -> std::optional<FieldValue>;
+
+        /**
+        * @brief Typed lookup: empty if there is no such field or its value doesn't convert.
+        *        T is bool, an integer (the stored value must be in its range), a floating point type
+        *        (integers convert too) or std::string_view (a view into this buffer).
+        */
+        template <typename T>
+        auto get(std::string_view key) const -> std::optional<T>;
+    private:
+        bool append(const void* src, std::size_t bytes) {
+            if (m_Size + bytes > capacity) {
+                return false;
+            }
+            std::memcpy(m_Data.data() + m_Size, src, bytes);
+            m_Size += static_cast<u16>(bytes);
+            return true;
+        }
+    private:
+        std::array<std::byte, capacity> m_Data;
+        u16                             m_Size    = 0;
+        u8                              m_Count   = 0;
+        u8                              m_Dropped = 0;
+    };
+
+    template <typename T>
+    auto FieldBuffer::get(std::string_view key) const -> std::optional<T> {
+        auto value = find(key);
+        if (!value) {
+            return std::nullopt;
+        }
+        return std::visit([](const auto& v) -> std::optional<T> {
+            using V = std::remove_cvref_t<decltype(v)>;
+            if constexpr (std::is_same_v<T, V>) {
+                return v;
+            } else if constexpr (std::is_same_v<T, bool> || std::is_same_v<V, bool> ||
+                                 std::is_same_v<T, std::string_view> || std::is_same_v<V, std::string_view>) {
+                return std::nullopt;
+            } else if constexpr (std::is_integral_v<T>) {
+                if constexpr (std::is_integral_v<V>) {
+                    if (std::in_range<T>(v)) {
+                        return static_cast<T>(v);
+                    }
+                }
+                return std::nullopt;
+            } else if constexpr (std::is_floating_point_v<T>) {
+                return static_cast<T>(v);
+            } else {
+                return std::nullopt;
+            }
+        }, *value);
+    }
+
+}
@@ -1,13 +1,27 @@
 #pragma once
 
 #include "Types.h"
+#include "Timestamp.h"
+#include "ArgBuffer.h"
+#include "Fields.h"
+#include "Metrics.h"
+#include "RateLimit.h"
+#include "containers/BoundedQueue.hpp"
 #include <string>
 #include <fstream>
 #include <mutex>
 #include <vector>
+#include <array>
 #include <span>
 #include <map>
 #include <functional>
+#include <optional>
+#include <format>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <concepts>
+#include <initializer_list>
 
 namespace aby::log {
 
@@ -22,44 +36,315 @@ namespace aby::log {
         ALL,
     };
 
+    inline constexpr std::size_t level_count = static_cast<std::size_t>(ELevel::ALL) + 1;
+
+    enum class EOverflowPolicy {
+        BLOCK,        // Producer waits until the backend frees a slot.
+        DROP_NEWEST,  // Incoming message is discarded.
+        DROP_OLDEST,  // Oldest queued message is discarded to make room.
+    };
+
+    /**
+    * @brief When a buffered file sink hands its buffer to the OS.
+    *        The interval is checked on write and by the async backend while idle,
+    *        in sync mode a quiet logger keeps its tail buffered until the next write or flush().
+    */
+    struct FlushPolicy {
+        std::size_t               bytes    = 32 * 1024;                        // Flush once this much is buffered, 0 = only when full.
+        std::chrono::milliseconds interval = std::chrono::milliseconds(1000);  // Flush when the oldest buffered message is this old, 0 = off.
+        ELevel                    level    = ELevel::ERROR;                    // Messages at or above this level flush immediately.
+    };
+
+    /**
+    * @brief When a log file is closed and replaced by a fresh one.
+    *        Checked on each write to the file, so a quiet log rotates with its next message.
+    */
+    struct RotationPolicy {
+        u64                  max_bytes = 0;                       // Rotate before a write would grow the file past this, 0 = off.
+        std::chrono::seconds interval  = std::chrono::seconds(0); // Rotate at every multiple of this since the epoch, 0 = off.
+        u32                  keep      = 0;                       // Closed segments kept per file, older ones are deleted. 0 = keep all.
+        bool                 compress  = true;                    // Pack closed segments to "<segment>.lz" in the background (see Compression.h).
+    };
+
+    /**
+    * @brief Per-thread staging of formatted lines (sync mode only).
+    *        Each producer formats into its own buffer without taking the logger lock and hands
+    *        whole batches to the console and files, so lock and syscall counts scale with batches
+    *        instead of messages. Lines from different threads interleave per batch.
+    *        Logging with record sinks (Config::sinks) configured, or with a file or console that has
+    *        its own levels or formatter, bypasses staging.
+    */
+    struct StagingPolicy {
+        bool                      enabled = false;
+        std::size_t               bytes   = 16 * 1024;                        // Hand the batch over once this much is staged.
+        std::chrono::milliseconds linger  = std::chrono::milliseconds(50);    // Longest a staged line waits, enforced by a flusher thread. 0 = until bytes/flush/thread exit.
+        ELevel                    level   = ELevel::ERROR;                    // Messages at or above this level hand the batch over immediately.
+    };
+
+    class FileSink;
+    class ISink;
+    class IFormatter;
+    class ConsoleSink;
+    struct FormatContext;
+    class SegmentArchiver;
+    class CallbackWorker;
+
+    enum class EMessageType {
+        LOG,        // A logged message.
+        ROTATED,    // A log file was rotated, file is the closed segment.
+        COMPRESSED, // A closed segment was compressed, file is the archive.
+        REMOVED,    // A closed segment was deleted by the retention policy, file is what got deleted.
+    };
+
     struct Message {
-        std::string timestamp;
-        std::string text;
-        ELevel      level = ELevel::NONE;
+        std::string  timestamp;
+        std::string  text;   // The formatted line, without color codes (those only go to the console).
+        ELevel       level = ELevel::NONE;
+        EMessageType type  = EMessageType::LOG;
+        fs::path     file;   // Set for file events.
+        FieldBuffer  fields; // Structured fields of a log_*_kv call.
+
+        // Typed field access, e.g. msg.field<i64>("id"). See FieldBuffer::get().
+        template <typename T>
+        auto field(std::string_view key) const -> std::optional<T> { return fields.get<T>(key); }
     };
 
     /**
     * @brief  Callback when message is logged.
-    * @param  Message: message that got logged, already formatted. contains ansii codes.
+    * @param  Message: message that got logged, already formatted (no color codes), with its fields.
     * @return Optional error message if something went wrong during callback.
     * @throws DO NOT CALL LOGGER FUNCTIONS IN CALLBACK!
     */
     using Callback = std::function<std::optional<std::string>(const Message&)>;
 
+    // One bit per ELevel, see level_bit().
+    using LevelMask = u32;
+
+    inline constexpr LevelMask all_levels = ~LevelMask(0);
+
+    constexpr auto level_bit(ELevel level) -> LevelMask {
+        return LevelMask(1) << static_cast<int>(level);
+    }
+
+    constexpr auto level_mask(std::initializer_list<ELevel> levels) -> LevelMask {
+        LevelMask mask = 0;
+        for (auto level : levels) {
+            mask |= level_bit(level);
+        }
+        return mask;
+    }
+
+    // Every level up to level, the levels Config::level lets through when set to it.
+    constexpr auto levels_up_to(ELevel level) -> LevelMask {
+        return (level_bit(level) << 1) - 1;
+    }
+
+    // Whether levels takes everything a logger can log.
+    constexpr bool takes_all_levels(LevelMask levels) {
+        return (levels & levels_up_to(ELevel::ALL)) == levels_up_to(ELevel::ALL);
+    }
+
+    enum class ECallbackMode {
+        INLINE, // Called by the thread that dispatches the message, while it holds the logger lock.
+        WORKER, // Called on the subscription's own thread, fed through a bounded queue.
+    };
+
+    /**
+    * @brief A callback plus which messages it wants and where it runs.
+    *        A WORKER subscription gets copies of matching messages through its own queue,
+    *        so a slow callback only backs up that queue (see CallbackStats) instead of every logging thread.
+    *        The worker holds its own copy of the callback. Replace it through set_callback() or by assigning a
+    *        new Subscription, both change generation, which restarts the worker. Assigning callback directly doesn't.
+    */
+    struct Subscription {
+        Subscription() = default;
+        template <typename F> requires std::constructible_from<Callback, F>
+        Subscription(F&& callback) : callback(std::forward<F>(callback)), generation(next_generation()) {}
+
+        Subscription& set_callback(Callback callback);
+        Subscription& set_levels(LevelMask levels);
+        Subscription& set_mode(ECallbackMode mode);
+        Subscription& set_queue_capacity(std::size_t capacity);
+        Subscription& set_overflow_policy(EOverflowPolicy policy);
+
+        Callback        callback;
+        LevelMask       levels         = all_levels;
+        ECallbackMode   mode           = ECallbackMode::INLINE;
+        std::size_t     queue_capacity = 1024;                        // WORKER only.
+        EOverflowPolicy overflow       = EOverflowPolicy::DROP_NEWEST; // WORKER only, what a full queue does to the dispatching thread.
+        u64             generation     = 0;                            // Process-wide unique per callback set, copies keep it.
+
+        static auto next_generation() -> u64;
+    };
+
+    /**
+    * @brief Counters of one subscription, in Config::callbacks order.
+    */
+    struct CallbackStats {
+        u64          delivered = 0; // Callback invocations.
+        u64          dropped   = 0; // Messages lost to a full queue.
+        u64          blocked   = 0; // Dispatches that had to wait for room (EOverflowPolicy::BLOCK).
+        std::size_t  queued    = 0; // Messages waiting right now.
+        LatencyStats latency;       // Time spent inside the callback.
+    };
+
+    /**
+    * @brief One output in MetricsSnapshot::outputs.
+    */
+    struct OutputStats {
+        std::string name;        // "console", the log file path, or "sink <i>" for Config::sinks[i].
+        bool        open = true; // False for a log file that couldn't be opened, its writes count as errors.
+        IoStats     io;
+    };
+
+    /**
+    * @brief The logger's counters at one point in time, see Logger::metrics().
+    *        Everything counts from startup, since() gives the activity between two snapshots.
+    *        Producer-side numbers are summed from per-thread blocks, so they may trail the outputs slightly.
+    */
+    struct MetricsSnapshot {
+        std::chrono::steady_clock::time_point taken;
+        std::array<u64, level_count>          messages{};            // Logged (past the level check), per ELevel.
+        u64                                   dropped           = 0; // Discarded by the overflow policy.
+        u64                                   blocked           = 0; // Producers that found the async queue full and waited.
+        u64                                   fields_dropped    = 0; // Structured fields that didn't fit their record.
+        std::size_t                           queue_depth       = 0; // Records waiting for the backend thread right now.
+        std::size_t                           queue_capacity    = 0; // 0 while no backend thread runs.
+        u64                                   lock_acquisitions = 0; // Output lock taken to write records.
+        u64                                   lock_contended    = 0; // The ones that found it held.
+        LatencyStats                          lock_wait;             // How long those waited.
+        LatencyStats                          enqueue_wait;          // How long blocked producers waited for room.
+        std::vector<OutputStats>              outputs;               // Console, then Config::log_files (once opened), then Config::sinks.
+        std::vector<CallbackStats>            callbacks;             // In Config::callbacks order.
+
+        auto total_messages() const -> u64;
+        // Sum of the outputs' IoStats.
+        auto io() const -> IoStats;
+        // Counters since earlier, a snapshot of the same logger. Gauges (queue_depth, queued, max_ns) stay current.
+        auto since(const MetricsSnapshot& earlier) const -> MetricsSnapshot;
+    };
+
+    /**
+    * @brief A Config::log_files entry: the path, which levels go to it and how its lines are formatted.
+    *        Converts from a path, so the file takes every level in the logger's text layout.
+    */
+    struct LogFile {
+        LogFile(const fs::path& path, LevelMask levels = all_levels, Ref<IFormatter> formatter = nullptr) :
+            path(path), levels(levels), formatter(std::move(formatter)) {}
+        LogFile(const char* path) : LogFile(fs::path(path)) {}
+        LogFile(const std::string& path) : LogFile(fs::path(path)) {}
+
+        fs::path        path;
+        LevelMask       levels    = all_levels;
+        Ref<IFormatter> formatter; // Null for the logger's text layout, see sinks/Sink.h.
+    };
+
     struct Config {
         Config& set_level(ELevel level);
         Config& set_to_console(bool to_console);
         Config& set_color(ELevel level, const std::string& color);
         Config& set_level_name(ELevel level, const std::string& name);
-        Config& add_file(const fs::path& path);
+        Config& add_file(const fs::path& path, LevelMask levels = all_levels, Ref<IFormatter> formatter = nullptr);
         Config& add_callback(Callback&& callback);
+        Config& subscribe(Subscription subscription);
+        Config& set_async(bool async);
+        Config& set_queue_capacity(std::size_t capacity);
+        Config& set_overflow_policy(EOverflowPolicy policy);
+        Config& set_file_buffer_size(std::size_t bytes);
+        Config& set_file_flush_policy(const FlushPolicy& policy);
+        Config& set_time_precision(ETimePrecision precision);
+        Config& set_file_rotation(const RotationPolicy& policy);
+        Config& set_staging(const StagingPolicy& policy);
+        Config& add_sink(Ref<ISink> sink);
+        Config& set_console(Ref<ConsoleSink> console);
 
-        ELevel                        level      = ELevel::ALL;                       
+        ELevel                        level      = ELevel::ALL; // Logs levels at or below this one in ELevel order, the opposite of ABY_LOG_MIN_LEVEL.
         bool                          to_console = true;
-        std::vector<fs::path>         log_files;                            
-        std::vector<Callback>         callbacks; // Do not make logger calls inside callback.
+        Ref<ConsoleSink>              console;   // Written while to_console is set, its levels and formatter apply (see sinks/ConsoleSink.h).
+        std::vector<LogFile>          log_files;
+        std::vector<Subscription>     callbacks; // Do not make logger calls inside callback.
         std::map<ELevel, std::string> level_names;
         std::map<ELevel, std::string> level_colors;
+        bool                          async          = false;  // Format and write on a background thread.
+        std::size_t                   queue_capacity = 8192;   // Read once, when the backend thread first starts. The queue then lives as long as the logger.
+        EOverflowPolicy               overflow       = EOverflowPolicy::BLOCK;
+        std::size_t                   file_buffer_size = 64 * 1024; // Read when a file is opened.
+        FlushPolicy                   file_flush;
+        RotationPolicy                file_rotation; // Read when a file is opened.
+        StagingPolicy                 staging;       // Call Logger::flush() before turning it off or switching to async.
+        ETimePrecision                time_precision = ETimePrecision::SECONDS;
+        std::vector<Ref<ISink>>       sinks; // Record-level outputs (see sinks/Sink.h), each with its own levels and formatter.
+    };
+
+    /**
+    * @brief Static description of a log_* call site, built at compile time by the macros.
+    *        Records point at it instead of carrying the file name and format string around.
+    */
+    struct CallSite {
+        std::string_view file;
+        int              line  = 0;
+        ELevel           level = ELevel::NONE;
+        std::string_view fmt;
     };
 
+    /**
+    * @brief Unformatted message as handed from a producer to the backend thread.
+    *        Either text is already rendered, or render turns site->fmt + args into text when an output needs it.
+    *        site is set for log_* call sites either way. A non-zero fence marks a flush request instead of a message.
+    */
+    struct Record {
+        ELevel                                level = ELevel::NONE;
+        std::chrono::system_clock::time_point time;
+        std::string                           text;
+        u64                                   fence  = 0;
+        const CallSite*                       site   = nullptr;
+        RenderFn                              render = nullptr;
+        ArgBuffer                             args;
+        FieldBuffer                           fields;
+    };
+
+    /**
+    * @brief A logger instance: its own config, outputs, lock, async backend and metrics.
+    *        get() is the default logger the log_* macros write to. Subsystems that log a lot can get a
+    *        named one each (get(name)) and write to it through the log_*_to macros, so they don't share
+    *        a config or contend on one lock. Outputs are called under their logger's lock, so a file or sink
+    *        belongs to one logger, while each logger's ConsoleSink writes whole lines and can share the
+    *        terminal. Segment compression and retention run on one archiver thread shared by all loggers.
+    *        A callback may log to another logger, but not back into one whose callback is running on the
+    *        same thread, and two loggers whose inline callbacks log into each other can deadlock.
+    */
     class Logger {
     public:
-        Logger();
-        ~Logger() = default; 
+        explicit Logger(std::string name = "default");
+        ~Logger(); 
 
+        // The default logger, registered as "default".
         static auto get() -> Logger&;
+        /**
+        * @brief The logger registered under name, created with the default Config the first time.
+        *        The lookup takes a process-wide lock, resolve it once and keep the reference
+        *        (e.g. static auto& net = Logger::get("net");), named loggers live until exit.
+        */
+        static auto get(std::string_view name) -> Logger&;
+        // The logger registered under name, null if there is none yet.
+        static auto find(std::string_view name) -> Logger*;
+
+        auto name() const -> const std::string&;
         auto config() -> Config&;
 
+        /**
+        * @brief Typed front end used by the log_* macros.
+        *        Checks the level before doing anything else. Supported argument types (see CDeferredArg)
+        *        are captured as raw bytes and only formatted once an output consumes the record,
+        *        anything else is formatted on the calling thread.
+        */
+        template <typename... Args>
+        void log(const CallSite& site, std::format_string<Args...> fmt, Args&&... args);
+        // log() with structured fields, used by the log_*_kv macros. Fields that don't fit the record are dropped.
+        template <typename... Args>
+        void log_fields(const CallSite& site, std::initializer_list<Field> fields, std::format_string<Args...> fmt, Args&&... args);
+        bool enabled(ELevel level) const;
+
         void write(ELevel level, const std::string& msg);
         void trace(const std::string& msg);
         void info(const std::string& msg);
@@ -67,20 +352,178 @@ namespace aby::log {
         void debug(const std::string& msg);
         void error(const std::string& msg);
         void assertion(std::string_view file, int line, const char* func, const char* expr, const std::string& msg);
+        // "Suppressed <count> similar messages from <file>:<line>" at the site's level, used by the log_*_limited macros.
+        void report_suppressed(const CallSite& site, u64 count);
+        // Have flush(), the backend/flusher threads and the destructor report what limiter swallows, see Limiter.
+        void track_limiter(const CallSite& site, Limiter& limiter);
+
+        /**
+        * @brief Block until every message logged before this call has reached the outputs.
+        *        In async mode this waits for the backend thread to drain the queue,
+        *        with staging it hands every thread's staged batch over.
+        *        Like logging, it must not be called from one of this logger's callbacks.
+        */
+        void flush();
+        // Messages discarded by the overflow policy since startup.
+        auto dropped() const -> u64;
+        auto callback_stats() -> std::vector<CallbackStats>;
+        /**
+        * @brief Collect the counters of every thread and output into a snapshot.
+        *        Takes the logger lock briefly, meant for periodic polling (see MetricsReporter), not per message.
+        */
+        auto metrics() -> MetricsSnapshot;
     private:
-        auto format(ELevel level, const std::string& msg) -> std::string;
-        void write_files(const std::string& formatted_msg);
-        void write_console(const std::string& formatted_msg);
+        auto format(ELevel level, const std::string& msg, bool color) -> std::string;
+        void format_to(std::string& out, ELevel level, std::string_view timestamp, std::string_view text, bool color);
+        auto render(const Record& record) -> std::string_view;
+        // The line formatter makes for ctx, formatted at most once per dispatch. Null is the plain text layout.
+        auto rendering(const IFormatter* formatter, const FormatContext& ctx) -> std::string_view;
+        void submit(Record&& record);
+        void dispatch(const Record& record);
+        void write_files(const FormatContext& ctx);
+        void write_files(ELevel level, std::string_view formatted_msg);
+        void open_files();
+        void flush_outputs();
+        void flush_outputs_if_due(std::chrono::steady_clock::time_point now);
+        auto console_for(ELevel level) const -> ConsoleSink*;
+        void write_console(ELevel level, std::string_view formatted_msg);
+        bool console_colored() const;
+        auto console_formatter() const -> const IFormatter*;
+        bool stageable() const;
         void handle_callbacks(const Message& msg);
+        bool has_subscribers(ELevel level);
+        void sync_subscribers();
+        void report_callback_error(std::string_view error);
+        void report_worker_errors();
+        void abort_reentrant();
+        void on_rotated(const fs::path& active, const fs::path& segment);
+        void on_archived(EMessageType type, const fs::path& file);
+        auto file_event(EMessageType type, const fs::path& file) -> Message;
+        void deliver_events();
+        // Summaries of the tracked limiters, only those whose window is over unless all. direct dispatches
+        // them right away, for the backend thread (which can't queue to itself) and the destructor.
+        void report_limiters(bool all, bool direct);
+
+        struct ThreadMetrics;
+        struct MetricsRegistry;
+        struct MetricsHandle;
+        auto thread_metrics() -> ThreadMetrics&;
+        // Takes m_Mutex, timing the wait into metrics if it is contended.
+        auto lock_outputs(ThreadMetrics* metrics) -> std::unique_lock<std::mutex>;
+
+        void enqueue(Record&& record, EOverflowPolicy policy, ThreadMetrics* metrics = nullptr);
+        // Count the caller in as a producer if the backend runs, false (not counted) if it doesn't.
+        bool enter_queue();
+        void leave_queue();
+        void start_backend();
+        void stop_backend();
+        void backend_loop();
+        // One popped record: dispatched, or for a fence the outputs are flushed before it completes.
+        void consume(Record& record);
+        void complete_fence(u64 fence);
+
+        struct Stage;
+        struct StageRegistry;
+        struct StageHandle;
+        void stage(const Record& record);
+        auto local_stage() -> Stage&;
+        void drain_stage(Stage& stage, ThreadMetrics* metrics = nullptr);
+        void drain_all_stages();
+        void start_flusher();
+        void stop_flusher();
+        void flusher_loop();
     private:
-        Config     m_Cfg;
-        std::mutex m_Mutex;
-        bool       bInCallbacks;
+        std::string m_Name;
+        Config      m_Cfg;
+        std::mutex  m_Mutex;
+        std::vector<Unique<FileSink>> m_Files; // Opened lazily for each Config::log_files entry.
+        TimestampCache                m_Timestamps;
+        std::string                   m_Text; // Scratch for rendering deferred records, guarded by m_Mutex.
+
+        struct Rendering {
+            const IFormatter* formatter = nullptr;
+            std::string       line;
+        };
+        std::vector<Rendering>        m_Renderings;        // One line per formatter in use, reused across dispatches. Guarded by m_Mutex.
+        std::size_t                   m_RenderingCount = 0; // Entries of m_Renderings valid for the current record.
+        Ref<SegmentArchiver>          m_Archiver;  // SegmentArchiver::shared().
+        std::vector<Message>          m_Events; // File events waiting for the next dispatch or flush, guarded by m_Mutex.
+        Ref<MetricsRegistry>          m_Metrics;      // Shared with each thread's handle, like m_Stages.
+
+        struct Subscriber;
+        std::vector<Subscriber>       m_Subscribers;      // Runtime side of Config::callbacks, guarded by m_Mutex.
+        LevelMask                     m_SubscribedLevels; // Union of the subscribers' masks.
+        std::mutex                    m_WorkerErrorsMutex;
+        std::vector<std::string>      m_WorkerErrors;     // Errors returned on worker threads, written by the next dispatch.
+        std::atomic<bool>             m_bWorkerErrors{ false };
+
+        struct TrackedLimiter {
+            const CallSite* site;
+            Limiter*        limiter;
+        };
+        std::mutex                    m_LimitersMutex;
+        std::vector<TrackedLimiter>   m_Limiters;          // Limiters that suppressed a message for this logger.
+        std::atomic<bool>             m_bLimiters{ false }; // m_Limiters isn't empty, skips the lock while idle.
+
+        using Queue = containers::BoundedQueue<Record>;
+        Unique<Queue>       m_Queue;
+        std::thread         m_Backend;
+        std::mutex          m_BackendMutex;
+        std::atomic<bool>   m_bBackendRunning{ false };
+        std::atomic<bool>   m_bBackendStopping{ false };
+        std::atomic<u32>    m_Producers{ 0 }; // Threads between enter_queue() and leave_queue().
+        std::atomic<u64>    m_FenceIssued{ 0 };
+        std::atomic<u64>    m_FenceDone{ 0 };
+        std::atomic<u64>    m_Dropped{ 0 };
+
+        Ref<StageRegistry>  m_Stages;  // Shared with each thread's handle, which may outlive the logger.
+        std::thread         m_Flusher; // Enforces StagingPolicy::linger.
     private:
+        friend class CallbackWorker;
         static Logger s_Logger;
     }; 
 
+    inline bool Logger::enabled(ELevel level) const {
+        return static_cast<int>(level) <= static_cast<int>(m_Cfg.level);
+    }
+
+    template <typename... Args>
+    void Logger::log(const CallSite& site, std::format_string<Args...> fmt, Args&&... args) {
+        log_fields(site, {}, fmt, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    void Logger::log_fields(const CallSite& site, std::initializer_list<Field> fields, std::format_string<Args...> fmt, Args&&... args) {
+        if (!enabled(site.level)) {
+            return;
+        }
+        Record record;
+        record.level = site.level;
+        record.time  = timestamp_now(m_Cfg.time_precision);
+        record.site  = &site;
+        if (fields.size()) {
+            record.fields.encode(fields);
+        }
+        if constexpr ((CDeferredArg<std::decay_t<Args>> && ...)) {
+            if (record.args.encode(args...)) {
+                record.render = &render_args<std::decay_t<Args>...>;
+                submit(std::move(record));
+                return;
+            }
+        }
+        record.text = std::format(fmt, std::forward<Args>(args)...);
+        submit(std::move(record));
+    }
+
+    /**
+    * @brief Append one log line in the logger's text layout: "[timestamp] [<color>LEVEL<reset>] text\n".
+    *        color = false leaves out the level_colors codes, the logger only colors console output.
+    */
+    void format_line(std::string& out, const Config& cfg, ELevel level, std::string_view timestamp, std::string_view text, bool color = true);
+
     auto current_time() -> std::string;
+    auto current_time(std::chrono::system_clock::time_point now) -> std::string;
+    // value with ',' between groups of three digits, see format_grouped() for the allocation-free form.
     auto format_with_commas(int64_t value) -> std::string;
 }
 
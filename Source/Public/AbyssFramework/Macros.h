@@ -77,6 +77,16 @@ extern "C" __declspec(dllimport) void __stdcall DebugBreak();
 #else // !(IF_DBG)
 #   define ABY_IF_DBG(x, el) el
 #endif // 
+
+// Profiling zones (Profiler.h) are kept only with -DABY_PROFILE_ENABLED.
+#ifdef ABY_PROFILE_ENABLED
+#   define ABY_IF_PROF(x, el) x
+#else // !(ABY_PROFILE_ENABLED)
+#   define ABY_IF_PROF(x, el) el
+#endif // ABY_PROFILE_ENABLED
+
+#define ABY_CONCAT_IMPL(a, b) a##b
+#define ABY_CONCAT(a, b) ABY_CONCAT_IMPL(a, b)
 // =============================================================
 // ANSI Text Colors
 // =============================================================
@@ -91,17 +101,121 @@ extern "C" __declspec(dllimport) void __stdcall DebugBreak();
 // =============================================================
 #define STYLE_UNDERLINE "\033[4m"
 // =============================================================
+// Compile-time Log Level
+// =============================================================
+// Numeric mirrors of aby::log::ELevel.
+#define ABY_LOG_LEVEL_NONE   0
+#define ABY_LOG_LEVEL_TRACE  1
+#define ABY_LOG_LEVEL_INFO   2
+#define ABY_LOG_LEVEL_WARN   3
+#define ABY_LOG_LEVEL_DEBUG  4
+#define ABY_LOG_LEVEL_ERROR  5
+#define ABY_LOG_LEVEL_ASSERT 6
+
+// log_* calls whose level is below this compile to nothing, arguments are not evaluated.
+// e.g. -DABY_LOG_MIN_LEVEL=ABY_LOG_LEVEL_WARN strips log_trace and log_info.
+// Note the opposite direction of Config::level, which lets through levels at or *below* it at run
+// time: what gets logged is [ABY_LOG_MIN_LEVEL, Config::level], and a runtime level under the
+// compile-time minimum logs nothing from these macros.
+#ifndef ABY_LOG_MIN_LEVEL
+#   define ABY_LOG_MIN_LEVEL ABY_LOG_LEVEL_NONE
+#endif // !(ABY_LOG_MIN_LEVEL)
+// =============================================================
 // Logging Macros
 // =============================================================
-#define log_trace(fmt, ...) ::aby::log::Logger::get().trace(std::format(fmt __VA_OPT__(,) __VA_ARGS__ ))
-#define log_info(fmt, ...)  ::aby::log::Logger::get().info(std::format(fmt __VA_OPT__(,) __VA_ARGS__ ))
-#define log_warn(fmt, ...)  ::aby::log::Logger::get().warn(std::format(fmt __VA_OPT__(,) __VA_ARGS__ ))
-#define log_err(fmt, ...)   ::aby::log::Logger::get().error(std::format(fmt __VA_OPT__(,) __VA_ARGS__ ))
-#define log_dbg(fmt, ...)   ABY_IF_DBG(::aby::log::Logger::get().debug(std::format(fmt __VA_OPT__(,) __VA_ARGS__ )), )
-#define log_assert(condition, fmt, ...)                                                                                                           \
-    ABY_IF_DBG(do {                                                                                                                               \
-        if (!(condition)) {                                                                                                                       \
-            ::aby::log::Logger::get().assertion(ABY_SOURCE_FILE, __LINE__, ABY_FUNC_SIG, #condition, std::format(fmt __VA_OPT__(,) __VA_ARGS__)); \
-            ABY_DBG_BREAK();                                                                                                                      \
-        }                                                                                                                                         \
-    } while(0), condition;)
\ No newline at end of file
+// The *_TO forms (and the log_*_to macros) write to logger, an expression naming an aby::log::Logger
+// that is only evaluated if the level isn't compiled out. Resolve named loggers once, e.g.
+//     static auto& net = ::aby::log::Logger::get("net");
+//     log_info_to(net, "connected to {}", peer);
+#define ABY_LOG_TO(logger, lvl, fmt, ...)                                                                          \
+    do {                                                                                                           \
+        if constexpr (static_cast<int>(lvl) >= ABY_LOG_MIN_LEVEL) {                                                \
+            static constexpr ::aby::log::CallSite aby_log_site{ ABY_SOURCE_FILE, __LINE__, lvl, fmt };             \
+            (logger).log(aby_log_site, fmt __VA_OPT__(,) __VA_ARGS__);                                             \
+        }                                                                                                          \
+    } while (0)
+#define ABY_LOG_AT(lvl, fmt, ...) ABY_LOG_TO(::aby::log::Logger::get(), lvl, fmt __VA_OPT__(,) __VA_ARGS__)
+
+// fields is a parenthesized list of { key, value } pairs, captured as typed aby::log::Field values, e.g.
+//     log_info_kv(({ "user", name }, { "id", id }, { "ms", elapsed }), "login from {}", ip);
+#define ABY_LOG_FIELDS(...) { __VA_ARGS__ }
+#define ABY_LOG_KV_TO(logger, lvl, fields, fmt, ...)                                                               \
+    do {                                                                                                           \
+        if constexpr (static_cast<int>(lvl) >= ABY_LOG_MIN_LEVEL) {                                                \
+            static constexpr ::aby::log::CallSite aby_log_site{ ABY_SOURCE_FILE, __LINE__, lvl, fmt };             \
+            (logger).log_fields(aby_log_site, ABY_LOG_FIELDS fields, fmt __VA_OPT__(,) __VA_ARGS__);               \
+        }                                                                                                          \
+    } while (0)
+#define ABY_LOG_KV_AT(lvl, fields, fmt, ...) ABY_LOG_KV_TO(::aby::log::Logger::get(), lvl, fields, fmt __VA_OPT__(,) __VA_ARGS__)
+
+// limiter is an aby::log::TokenBucket, Sampler or Deduplicator, constructed once per call site.
+// It is consulted after the level check and before any argument is captured, e.g.
+//     log_warn_limited(::aby::log::TokenBucket(10, 5), "retrying {}", id);
+//     log_err_limited(::aby::log::Sampler(3, 1000), "bad packet from {}", peer);
+//     log_info_limited(::aby::log::Deduplicator(std::chrono::seconds(1)), "cache miss");
+// The limiter belongs to the call site, not the logger it writes to. Suppressed counts are reported with
+// the next admitted message, or by the logger once the limiter's window is over (see Limiter).
+#define ABY_LOG_LIMITED_TO(logger, lvl, limiter, fmt, ...)                                                         \
+    do {                                                                                                           \
+        if constexpr (static_cast<int>(lvl) >= ABY_LOG_MIN_LEVEL) {                                                \
+            static constexpr ::aby::log::CallSite aby_log_site{ ABY_SOURCE_FILE, __LINE__, lvl, fmt };             \
+            static auto aby_log_limiter = limiter;                                                                 \
+            auto& aby_logger = (logger);                                                                           \
+            if (aby_logger.enabled(lvl)) {                                                                         \
+                if (auto aby_log_admission = aby_log_limiter.try_acquire()) {                                      \
+                    if (aby_log_admission.suppressed) {                                                            \
+                        aby_logger.report_suppressed(aby_log_site, aby_log_admission.suppressed);                 \
+                    }                                                                                              \
+                    aby_logger.log(aby_log_site, fmt __VA_OPT__(,) __VA_ARGS__);                                   \
+                } else if (aby_log_limiter.track()) {                                                              \
+                    aby_logger.track_limiter(aby_log_site, aby_log_limiter);                                       \
+                }                                                                                                  \
+            }                                                                                                      \
+        }                                                                                                          \
+    } while (0)
+#define ABY_LOG_LIMITED_AT(lvl, limiter, fmt, ...) ABY_LOG_LIMITED_TO(::aby::log::Logger::get(), lvl, limiter, fmt __VA_OPT__(,) __VA_ARGS__)
+
+#define log_trace(fmt, ...) ABY_LOG_AT(::aby::log::ELevel::TRACE, fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_info(fmt, ...)  ABY_LOG_AT(::aby::log::ELevel::INFO,  fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_warn(fmt, ...)  ABY_LOG_AT(::aby::log::ELevel::WARN,  fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_err(fmt, ...)   ABY_LOG_AT(::aby::log::ELevel::ERROR, fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_dbg(fmt, ...)   ABY_IF_DBG(ABY_LOG_AT(::aby::log::ELevel::DEBUG, fmt __VA_OPT__(,) __VA_ARGS__), )
+
+#define log_trace_kv(fields, fmt, ...) ABY_LOG_KV_AT(::aby::log::ELevel::TRACE, fields, fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_info_kv(fields, fmt, ...)  ABY_LOG_KV_AT(::aby::log::ELevel::INFO,  fields, fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_warn_kv(fields, fmt, ...)  ABY_LOG_KV_AT(::aby::log::ELevel::WARN,  fields, fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_err_kv(fields, fmt, ...)   ABY_LOG_KV_AT(::aby::log::ELevel::ERROR, fields, fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_dbg_kv(fields, fmt, ...)   ABY_IF_DBG(ABY_LOG_KV_AT(::aby::log::ELevel::DEBUG, fields, fmt __VA_OPT__(,) __VA_ARGS__), )
+
+#define log_trace_limited(limiter, fmt, ...) ABY_LOG_LIMITED_AT(::aby::log::ELevel::TRACE, limiter, fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_info_limited(limiter, fmt, ...)  ABY_LOG_LIMITED_AT(::aby::log::ELevel::INFO,  limiter, fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_warn_limited(limiter, fmt, ...)  ABY_LOG_LIMITED_AT(::aby::log::ELevel::WARN,  limiter, fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_err_limited(limiter, fmt, ...)   ABY_LOG_LIMITED_AT(::aby::log::ELevel::ERROR, limiter, fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_dbg_limited(limiter, fmt, ...)   ABY_IF_DBG(ABY_LOG_LIMITED_AT(::aby::log::ELevel::DEBUG, limiter, fmt __VA_OPT__(,) __VA_ARGS__), )
+
+#define log_trace_to(logger, fmt, ...) ABY_LOG_TO(logger, ::aby::log::ELevel::TRACE, fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_info_to(logger, fmt, ...)  ABY_LOG_TO(logger, ::aby::log::ELevel::INFO,  fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_warn_to(logger, fmt, ...)  ABY_LOG_TO(logger, ::aby::log::ELevel::WARN,  fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_err_to(logger, fmt, ...)   ABY_LOG_TO(logger, ::aby::log::ELevel::ERROR, fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_dbg_to(logger, fmt, ...)   ABY_IF_DBG(ABY_LOG_TO(logger, ::aby::log::ELevel::DEBUG, fmt __VA_OPT__(,) __VA_ARGS__), )
+
+#define log_trace_kv_to(logger, fields, fmt, ...) ABY_LOG_KV_TO(logger, ::aby::log::ELevel::TRACE, fields, fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_info_kv_to(logger, fields, fmt, ...)  ABY_LOG_KV_TO(logger, ::aby::log::ELevel::INFO,  fields, fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_warn_kv_to(logger, fields, fmt, ...)  ABY_LOG_KV_TO(logger, ::aby::log::ELevel::WARN,  fields, fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_err_kv_to(logger, fields, fmt, ...)   ABY_LOG_KV_TO(logger, ::aby::log::ELevel::ERROR, fields, fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_dbg_kv_to(logger, fields, fmt, ...)   ABY_IF_DBG(ABY_LOG_KV_TO(logger, ::aby::log::ELevel::DEBUG, fields, fmt __VA_OPT__(,) __VA_ARGS__), )
+
+#define log_trace_limited_to(logger, limiter, fmt, ...) ABY_LOG_LIMITED_TO(logger, ::aby::log::ELevel::TRACE, limiter, fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_info_limited_to(logger, limiter, fmt, ...)  ABY_LOG_LIMITED_TO(logger, ::aby::log::ELevel::INFO,  limiter, fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_warn_limited_to(logger, limiter, fmt, ...)  ABY_LOG_LIMITED_TO(logger, ::aby::log::ELevel::WARN,  limiter, fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_err_limited_to(logger, limiter, fmt, ...)   ABY_LOG_LIMITED_TO(logger, ::aby::log::ELevel::ERROR, limiter, fmt __VA_OPT__(,) __VA_ARGS__)
+#define log_dbg_limited_to(logger, limiter, fmt, ...)   ABY_IF_DBG(ABY_LOG_LIMITED_TO(logger, ::aby::log::ELevel::DEBUG, limiter, fmt __VA_OPT__(,) __VA_ARGS__), )
+
+#define log_assert_to(logger, condition, fmt, ...)                                                                                     \
+    ABY_IF_DBG(do {                                                                                                                     \
+        if (!(condition)) {                                                                                                             \
+            (logger).assertion(ABY_SOURCE_FILE, __LINE__, ABY_FUNC_SIG, #condition, std::format(fmt __VA_OPT__(,) __VA_ARGS__));        \
+            ABY_DBG_BREAK();                                                                                                            \
+        }                                                                                                                               \
+    } while(0), condition;)
+#define log_assert(condition, fmt, ...) log_assert_to(::aby::log::Logger::get(), condition, fmt __VA_OPT__(,) __VA_ARGS__)
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Types.h"
+#include <cstddef>
+
+namespace aby {
+
+    /**
+    * @brief File mapped into memory (mmap / MapViewOfFile), shared with the OS page cache.
+    *        Stores into a READ_WRITE mapping survive a crash of the process, sync() only
+    *        matters for surviving a crash of the machine.
+    */
+    class MappedFile {
+    public:
+        enum class EMode {
+            READ,       // Map the whole existing file read only.
+            READ_WRITE, // Create the file if needed and resize it to the requested size.
+        };
+
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        bool open(const fs::path& path, EMode mode, std::size_t size = 0);
+        void close();
+        // Block until dirty pages are written to the file.
+        bool sync();
+
+        bool is_open() const { return m_Data != nullptr; }
+        auto data() -> std::byte* { return m_Data; }
+        auto data() const -> const std::byte* { return m_Data; }
+        auto size() const -> std::size_t { return m_Size; }
+    private:
+        void swap(MappedFile& other) noexcept;
+    private:
+        std::byte*  m_Data   = nullptr;
+        std::size_t m_Size   = 0;
+#ifdef _WIN32
+        void*       m_File    = nullptr;
+        void*       m_Mapping = nullptr;
+#else
+        int         m_Fd      = -1;
+#endif
+    };
+
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "Types.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+
+namespace aby::log {
+
+    /**
+    * @brief Counter with a single writer (the thread owning the block it lives in) and any number of readers.
+    *        add() is a relaxed load and store, no locked instruction, readers may see it a little late.
+    */
+    class Counter {
+    public:
+        void add(u64 n = 1) {
+            m_Value.store(m_Value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        auto load() const -> u64 {
+            return m_Value.load(std::memory_order_relaxed);
+        }
+    private:
+        std::atomic<u64> m_Value{ 0 };
+    };
+
+    /**
+    * @brief Aggregated latencies: count, sum, max and power-of-two nanosecond buckets.
+    *        Bucket 0 holds 0ns, bucket i holds [2^(i-1), 2^i), the last one everything above.
+    */
+    struct LatencyStats {
+        static constexpr std::size_t bucket_count = 32; // The last bucket starts at ~1.07s.
+
+        u64                              count    = 0;
+        u64                              total_ns = 0;
+        u64                              max_ns   = 0;
+        std::array<u64, bucket_count>    buckets{};
+
+        static constexpr auto bucket_of(u64 ns) -> std::size_t {
+            return std::min<std::size_t>(std::bit_width(ns), bucket_count - 1);
+        }
+
+        auto mean_ns() const -> double {
+            return count ? static_cast<double>(total_ns) / static_cast<double>(count) : 0.0;
+        }
+
+        // Upper bound of the bucket holding the p-th fraction (0..1) of the samples, at most max_ns.
+        auto percentile_ns(double p) const -> u64 {
+            if (!count) {
+                return 0;
+            }
+            auto rank = static_cast<u64>(std::clamp(p, 0.0, 1.0) * static_cast<double>(count - 1)) + 1;
+            u64 seen = 0;
+            for (std::size_t i = 0; i < bucket_count; ++i) {
+                seen += buckets[i];
+                if (seen >= rank) {
+                    return i + 1 < bucket_count ? std::min(u64(1) << i, max_ns) : max_ns;
+                }
+            }
+            return max_ns;
+        }
+
+        LatencyStats& operator+=(const LatencyStats& other) {
+            count    += other.count;
+            total_ns += other.total_ns;
+            max_ns    = std::max(max_ns, other.max_ns);
+            for (std::size_t i = 0; i < bucket_count; ++i) {
+                buckets[i] += other.buckets[i];
+            }
+            return *this;
+        }
+
+        // What was recorded since earlier, a snapshot of the same histogram. max_ns stays the all-time max,
+        // a histogram that started over in between is returned whole.
+        auto since(const LatencyStats& earlier) const -> LatencyStats {
+            if (count < earlier.count) {
+                return *this;
+            }
+            LatencyStats delta = *this;
+            delta.count    -= earlier.count;
+            delta.total_ns -= earlier.total_ns;
+            for (std::size_t i = 0; i < bucket_count; ++i) {
+                delta.buckets[i] -= earlier.buckets[i];
+            }
+            return delta;
+        }
+    };
+
+    /**
+    * @brief Live latency histogram, single writer like Counter.
+    */
+    class Histogram {
+    public:
+        void record(u64 ns) {
+            bump(m_Buckets[LatencyStats::bucket_of(ns)], 1);
+            bump(m_Count, 1);
+            bump(m_Total, ns);
+            if (ns > m_Max.load(std::memory_order_relaxed)) {
+                m_Max.store(ns, std::memory_order_relaxed);
+            }
+        }
+
+        void record(std::chrono::steady_clock::duration elapsed) {
+            record(static_cast<u64>(std::max<i64>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), 0)));
+        }
+
+        // Adds this histogram to out.
+        void collect(LatencyStats& out) const {
+            out.count    += m_Count.load(std::memory_order_relaxed);
+            out.total_ns += m_Total.load(std::memory_order_relaxed);
+            out.max_ns    = std::max(out.max_ns, m_Max.load(std::memory_order_relaxed));
+            for (std::size_t i = 0; i < LatencyStats::bucket_count; ++i) {
+                out.buckets[i] += m_Buckets[i].load(std::memory_order_relaxed);
+            }
+        }
+    private:
+        static void bump(std::atomic<u64>& value, u64 n) {
+            value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+    private:
+        std::array<std::atomic<u64>, LatencyStats::bucket_count> m_Buckets{};
+        std::atomic<u64>                                          m_Count{ 0 };
+        std::atomic<u64>                                          m_Total{ 0 };
+        std::atomic<u64>                                          m_Max{ 0 };
+    };
+
+    /**
+    * @brief What an output handed to the OS. Kept by the output itself, under the logger lock.
+    */
+    struct IoStats {
+        u64 bytes  = 0; // Written.
+        u64 writes = 0; // Write calls that reached the OS.
+        u64 errors = 0; // Failed or short writes, and writes skipped because the output isn't open.
+        u64 lost   = 0; // Bytes that never made it out because of those.
+
+        IoStats& operator+=(const IoStats& other) {
+            bytes  += other.bytes;
+            writes += other.writes;
+            errors += other.errors;
+            lost   += other.lost;
+            return *this;
+        }
+    };
+
+}
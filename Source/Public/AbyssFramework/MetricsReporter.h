@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Log.h"
+#include <condition_variable>
+
+namespace aby::log {
+
+    /**
+    * @brief Periodic self-report: every interval takes Logger::metrics() and hands the totals and the
+    *        activity since the previous report to report.
+    *        Without a report function a summary goes through the logger itself at level, with the numbers
+    *        as structured fields (messages, dropped, blocked, queue_depth, lock_wait_p99_ns, callback_p99_ns,
+    *        write_errors, ...) so a JsonSink or a callback can alert on backpressure.
+    *        Runs its own thread, which is never a callback thread, so logging from report is fine.
+    */
+    class MetricsReporter {
+    public:
+        using ReportFn = std::function<void(const MetricsSnapshot& total, const MetricsSnapshot& delta)>;
+
+        MetricsReporter(Logger& logger, std::chrono::milliseconds interval, ReportFn report = {}, ELevel level = ELevel::INFO);
+        // Stops the thread, without a last report.
+        ~MetricsReporter();
+
+        MetricsReporter(const MetricsReporter&) = delete;
+        MetricsReporter& operator=(const MetricsReporter&) = delete;
+
+        // Report right away, on the calling thread. The next periodic report covers the time since this one.
+        void report_now();
+    private:
+        void run();
+        void log_report(const MetricsSnapshot& total, const MetricsSnapshot& delta);
+    private:
+        Logger&                   m_Logger;
+        std::chrono::milliseconds m_Interval;
+        ReportFn                  m_Report;
+        ELevel                    m_Level;
+        std::mutex                m_ReportMutex; // Serializes reports, guards m_Last.
+        MetricsSnapshot           m_Last;
+        std::mutex                m_Mutex;
+        std::condition_variable   m_Wake;
+        bool                      m_bStopping = false;
+        std::thread               m_Thread;
+    };
+
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Types.h"
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+namespace aby::log {
+
+    // Most characters the formatters below write, size caller buffers with these.
+    inline constexpr std::size_t max_decimal_chars = 20; // u64 max, or i64 min with its '-'.
+    inline constexpr std::size_t max_grouped_chars = 26; // i64 min with six separators.
+    inline constexpr std::size_t max_unit_chars    = 32; // format_bytes() and format_duration().
+
+    namespace detail {
+        // "00" to "99", two digits per division halves the divisions.
+        inline constexpr auto digit_pairs = [] {
+            std::array<char, 200> pairs{};
+            for (int i = 0; i < 100; ++i) {
+                pairs[2 * i]     = static_cast<char>('0' + i / 10);
+                pairs[2 * i + 1] = static_cast<char>('0' + i % 10);
+            }
+            return pairs;
+        }();
+    }
+
+    /**
+    * @brief Write the decimal digits of value backwards, ending right before end.
+    *        The max_decimal_chars bytes before end must be writable.
+    * @return Where the digits start.
+    */
+    inline auto write_decimal_backward(char* end, u64 value) -> char* {
+        while (value >= 100) {
+            auto pair = static_cast<std::size_t>(value % 100) * 2;
+            value /= 100;
+            end -= 2;
+            std::memcpy(end, detail::digit_pairs.data() + pair, 2);
+        }
+        if (value >= 10) {
+            end -= 2;
+            std::memcpy(end, detail::digit_pairs.data() + value * 2, 2);
+        } else {
+            *--end = static_cast<char>('0' + value);
+        }
+        return end;
+    }
+
+    inline auto write_decimal_backward(char* end, i64 value) -> char* {
+        // Negated as unsigned, so i64 min doesn't overflow.
+        auto magnitude = value < 0 ? u64(0) - static_cast<u64>(value) : static_cast<u64>(value);
+        char* begin = write_decimal_backward(end, magnitude);
+        if (value < 0) {
+            *--begin = '-';
+        }
+        return begin;
+    }
+
+    /**
+    * @brief value in decimal at out, what std::format("{}") prints for it. Like std::to_chars,
+    *        nothing is terminated and the end is returned. out needs max_decimal_chars of room.
+    */
+    template <std::integral T>
+        requires(!std::is_same_v<T, bool>)
+    inline auto format_decimal(char* out, T value) -> char* {
+        char  buffer[max_decimal_chars];
+        char* end = buffer + sizeof(buffer);
+        char* begin;
+        if constexpr (std::is_signed_v<T>) begin = write_decimal_backward(end, static_cast<i64>(value));
+        else                               begin = write_decimal_backward(end, static_cast<u64>(value));
+        std::memcpy(out, begin, static_cast<std::size_t>(end - begin));
+        return out + (end - begin);
+    }
+
+    // Append value in decimal to out.
+    template <std::integral T>
+        requires(!std::is_same_v<T, bool>)
+    inline void append_decimal(std::string& out, T value) {
+        char  buffer[max_decimal_chars];
+        char* end = buffer + sizeof(buffer);
+        char* begin;
+        if constexpr (std::is_signed_v<T>) begin = write_decimal_backward(end, static_cast<i64>(value));
+        else                               begin = write_decimal_backward(end, static_cast<u64>(value));
+        out.append(begin, end);
+    }
+
+    /**
+    * @brief value with separator between groups of three digits, "-1,234,567".
+    *        Returns the end, out needs max_grouped_chars of room.
+    */
+    auto format_grouped(char* out, i64 value, char separator = ',') -> char*;
+    auto format_grouped(char* out, u64 value, char separator = ',') -> char*;
+
+    /**
+    * @brief bytes in binary units with three significant digits: "512 B", "1.50 KiB", "12.3 MiB", "932 GiB".
+    *        Returns the end, out needs max_unit_chars of room.
+    */
+    auto format_bytes(char* out, u64 bytes) -> char*;
+
+    /**
+    * @brief duration with three significant digits in the largest unit that fits: "850 ns", "1.25 us",
+    *        "12.5 ms", "3.20 s". Seconds stay the unit past 1000 s. Returns the end, out needs max_unit_chars of room.
+    */
+    auto format_duration(char* out, std::chrono::nanoseconds duration) -> char*;
+
+}
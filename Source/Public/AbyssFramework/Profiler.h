@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Types.h"
+#include "Macros.h"
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace aby::prof {
+
+    /**
+    * @brief Static description of one profiled scope, one per ABY_PROFILE_SCOPE call site.
+    */
+    struct Zone {
+        std::string_view name;
+        std::string_view file;
+        std::string_view function;
+        int              line = 0;
+    };
+
+    // Monotonic nanoseconds, the clock every zone is timed with.
+    inline auto now() -> i64 {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    /**
+    * @brief Appends one finished zone to the calling thread's buffer.
+    *        The buffer is a chain of fixed-size blocks only this thread writes, publishing each
+    *        event with a release store. No lock and no allocation except once per block.
+    */
+    void record(const Zone& zone, i64 begin, i64 end);
+
+    // Name shown for the calling thread in exported traces.
+    void set_thread_name(std::string_view name);
+
+    /**
+    * @brief Times the enclosing scope, see ABY_PROFILE_SCOPE.
+    */
+    class Scope {
+    public:
+        explicit Scope(const Zone& zone) : m_Zone(zone), m_Begin(now()) {}
+        ~Scope() { record(m_Zone, m_Begin, now()); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        const Zone& m_Zone;
+        i64         m_Begin;
+    };
+
+    /**
+    * @brief Events taken out of the per-thread buffers, ready to export.
+    */
+    struct Capture {
+        struct ZoneInfo {
+            std::string name;
+            std::string file;
+            std::string function;
+            int         line = 0;
+        };
+
+        struct Event {
+            u32 zone  = 0; // Index into zones.
+            i64 begin = 0; // ns, steady clock.
+            i64 end   = 0;
+        };
+
+        struct Thread {
+            u32                id = 0; // Sequential, in order of the thread's first zone.
+            std::string        name;
+            std::vector<Event> events;
+        };
+
+        std::vector<ZoneInfo> zones;
+        std::vector<Thread>   threads;
+    };
+
+    /**
+    * @brief Moves every event recorded so far out of the per-thread buffers, and frees the blocks
+    *        they were in. Safe to call while other threads keep recording, events of zones
+    *        still open show up in a later capture. Buffers of exited threads go away once drained.
+    */
+    auto capture() -> Capture;
+
+    /**
+    * @brief Chrome trace-event JSON (chrome://tracing, Perfetto): one complete ("X") event per
+    *        zone, timestamps in microseconds from the earliest event, plus thread name metadata.
+    */
+    auto to_chrome_trace(const Capture& capture) -> std::string;
+    bool write_chrome_trace(const Capture& capture, const fs::path& path);
+
+    /**
+    * @brief Compact binary form (little endian):
+    *          "ABYPROF" u8 version, u32 zone count, u32 thread count,
+    *          per zone:   u32 line, u16 len + name, u16 len + file, u16 len + function,
+    *          per thread: u32 id, u16 len + name, u64 event count, events as u32 zone, i64 begin, i64 duration.
+    *        AbyssFrameworkProfDump turns it into Chrome JSON.
+    */
+    namespace binprof {
+        inline constexpr char magic[7] = { 'A', 'B', 'Y', 'P', 'R', 'O', 'F' };
+        inline constexpr u8   version  = 1;
+    }
+
+    bool write_binary(const Capture& capture, const fs::path& path);
+    // False if the file is missing, malformed or from another version.
+    bool read_binary(const fs::path& path, Capture& out);
+
+}
+
+// =============================================================
+// Profiling Macros
+// =============================================================
+// Zones are compiled in only with -DABY_PROFILE_ENABLED (CMake option ABY_PROFILE), otherwise
+// the macros expand to nothing (see ABY_IF_PROF) and leave no code or data behind.
+#define ABY_PROFILE_ZONE_IMPL(name, id)                                                                            \
+    static constexpr ::aby::prof::Zone ABY_CONCAT(aby_prof_zone_, id){ name, ABY_SOURCE_FILE, ABY_FUNC_SIG, __LINE__ }; \
+    const ::aby::prof::Scope ABY_CONCAT(aby_prof_scope_, id)(ABY_CONCAT(aby_prof_zone_, id))
+
+// Times the rest of the enclosing scope, e.g. ABY_PROFILE_SCOPE("decode");
+#define ABY_PROFILE_SCOPE(name) ABY_IF_PROF(ABY_PROFILE_ZONE_IMPL(name, __LINE__), )
+#define ABY_PROFILE_FUNCTION()  ABY_IF_PROF(ABY_PROFILE_ZONE_IMPL(__func__, __LINE__), )
+#define ABY_PROFILE_THREAD(name) ABY_IF_PROF(::aby::prof::set_thread_name(name), )
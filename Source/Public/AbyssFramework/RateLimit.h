@@ -0,0 +1,170 @@
+#pragma once
+
+#include "Types.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <type_traits>
+
+namespace aby::log {
+
+    /**
+    * @brief Result of asking a limiter whether a message may be logged.
+    *        suppressed is the number of messages the limiter swallowed since the last admitted one,
+    *        the caller reports it next to the admitted message.
+    */
+    struct Admission {
+        bool allowed    = false;
+        u64  suppressed = 0;
+
+        explicit operator bool() const { return allowed; }
+    };
+
+    /*
+    * Per call site limiters used by the log_*_limited macros (see Macros.h), one static instance per site.
+    * try_acquire() is a few atomic operations and runs before any argument is captured or formatted.
+    */
+
+    /**
+    * @brief What the limiters share: the count of swallowed messages. The log_*_limited macros hand a
+    *        limiter to its logger the first time it swallows one (track()), and the logger sweeps it from
+    *        flush(), its backend or flusher thread and its destructor, so a burst that stops still gets
+    *        its "suppressed" summary instead of waiting for a next message that may never come.
+    */
+    class Limiter {
+    public:
+        /**
+        * @brief Take the suppressed count for a summary. 0 if there is none, or if all is false and the
+        *        limiter is still holding messages back: the next admitted message reports it then.
+        */
+        auto take_suppressed(bool all) -> u64 {
+            if (m_Suppressed.load(std::memory_order_relaxed) == 0 || (!all && !expired())) {
+                return 0;
+            }
+            return m_Suppressed.exchange(0, std::memory_order_relaxed);
+        }
+
+        // True for the first caller only, which registers the limiter with its logger.
+        bool track() {
+            return !m_bTracked.load(std::memory_order_relaxed) && !m_bTracked.exchange(true, std::memory_order_relaxed);
+        }
+        // The logger is going away, the next suppression registers with whichever logger the site writes to then.
+        void untrack() { m_bTracked.store(false, std::memory_order_relaxed); }
+    protected:
+        Limiter() = default;
+        ~Limiter() = default;
+
+        // True once the limiter would admit a message again.
+        virtual bool expired() const = 0;
+
+        void suppress() { m_Suppressed.fetch_add(1, std::memory_order_relaxed); }
+        auto admit() -> Admission { return { true, m_Suppressed.exchange(0, std::memory_order_relaxed) }; }
+    private:
+        std::atomic<u64>  m_Suppressed{ 0 };
+        std::atomic<bool> m_bTracked{ false };
+    };
+
+    /**
+    * @brief Token bucket: sustained per_second messages with bursts of up to burst.
+    *        Kept as a single "theoretical arrival time" (GCRA), so admitting is one CAS.
+    */
+    class TokenBucket final : public Limiter {
+    public:
+        TokenBucket(double per_second, u32 burst = 1) :
+            m_Interval(static_cast<i64>(1e9 / std::max(per_second, 1e-9))),
+            m_Tolerance(m_Interval * static_cast<i64>(std::max<u32>(burst, 1) - 1))
+        {}
+
+        auto try_acquire() -> Admission {
+            i64 now = now_ns();
+            i64 tat = m_Tat.load(std::memory_order_relaxed);
+            do {
+                if (now < tat - m_Tolerance) {
+                    suppress();
+                    return {};
+                }
+            } while (!m_Tat.compare_exchange_weak(tat, std::max(tat, now) + m_Interval, std::memory_order_relaxed));
+            return admit();
+        }
+    private:
+        bool expired() const override {
+            return now_ns() >= m_Tat.load(std::memory_order_relaxed) - m_Tolerance;
+        }
+
+
+        static auto now_ns() -> i64 {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+    private:
+        const i64        m_Interval;  // ns per token.
+        const i64        m_Tolerance; // How far ahead of now the arrival time may run (burst - 1 tokens).
+        std::atomic<i64> m_Tat{ 0 };
+    };
+
+    /**
+    * @brief Sampling: the first first messages, then every every-th one. every = 0 keeps only the first ones.
+    */
+    class Sampler final : public Limiter {
+    public:
+        Sampler(u64 first, u64 every) :
+            m_First(first),
+            m_Every(every)
+        {}
+
+        auto try_acquire() -> Admission {
+            u64 n = m_Count.fetch_add(1, std::memory_order_relaxed);
+            if (n < m_First || (m_Every && (n - m_First) % m_Every == 0)) {
+                return admit();
+            }
+            suppress();
+            return {};
+        }
+    private:
+        // No window to wait for, every sweep reports what was skipped since the last one.
+        bool expired() const override { return true; }
+    private:
+        const u64        m_First;
+        const u64        m_Every;
+        std::atomic<u64> m_Count{ 0 };
+    };
+
+    /**
+    * @brief Time-window deduplication: one message per window, the ones in between are counted
+    *        and reported as "suppressed K similar messages" with the next admitted one, or by the
+    *        logger's sweep once the window is over.
+    *        Similar means same call site, arguments are not compared (that would need formatting).
+    */
+    class Deduplicator final : public Limiter {
+    public:
+        explicit Deduplicator(std::chrono::milliseconds window) :
+            m_Window(std::chrono::duration_cast<std::chrono::nanoseconds>(window).count())
+        {}
+
+        auto try_acquire() -> Admission {
+            i64 now = now_ns();
+            i64 end = m_WindowEnd.load(std::memory_order_relaxed);
+            if (now < end || !m_WindowEnd.compare_exchange_strong(end, now + m_Window, std::memory_order_relaxed)) {
+                suppress();
+                return {};
+            }
+            return admit();
+        }
+    private:
+        static auto now_ns() -> i64 {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        bool expired() const override {
+            return now_ns() >= m_WindowEnd.load(std::memory_order_relaxed);
+        }
+    private:
+        const i64        m_Window;
+        std::atomic<i64> m_WindowEnd{ 0 };
+    };
+
+    // A logger may sweep a site's limiter during static destruction, after the site's static is gone.
+    // Trivially destructible limiters leave their storage untouched, so that stays harmless.
+    static_assert(std::is_trivially_destructible_v<TokenBucket> && std::is_trivially_destructible_v<Sampler> &&
+                  std::is_trivially_destructible_v<Deduplicator>);
+
+}
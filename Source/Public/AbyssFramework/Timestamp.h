@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Types.h"
+#include <array>
+#include <chrono>
+#include <string_view>
+
+namespace aby::log {
+
+    enum class ETimePrecision {
+        SECONDS,      // 15-Oct-2026•13:37:00
+        MILLISECONDS, // 15-Oct-2026•13:37:00.042
+        MICROSECONDS, // 15-Oct-2026•13:37:00.042133
+    };
+
+    /**
+    * @brief  Wall clock read for log records.
+    *         Uses the coarse (tick resolution, no syscall) clock where available when
+    *         only whole seconds will be printed.
+    */
+    auto timestamp_now(ETimePrecision precision) -> std::chrono::system_clock::time_point;
+
+    /**
+    * @brief Formats log timestamps without calling localtime/format per message.
+    *        The "DD-Mon-YYYY•HH:MM:" prefix is rebuilt once per minute, within the
+    *        minute only the seconds and sub-second digits are rewritten in place.
+    *        Not thread safe, keep one per thread or guard it.
+    */
+    class TimestampCache {
+    public:
+        explicit TimestampCache(ETimePrecision precision = ETimePrecision::SECONDS);
+
+        // The returned view stays valid until the next call.
+        auto format(std::chrono::system_clock::time_point time) -> std::string_view;
+
+        void set_precision(ETimePrecision precision);
+        auto precision() const -> ETimePrecision;
+    private:
+        void rebuild_prefix(i64 epoch_seconds);
+    private:
+        static constexpr std::size_t capacity = 48;
+
+        ETimePrecision             m_Precision;
+        std::array<char, capacity> m_Buffer;
+        std::size_t                m_PrefixLen;
+        i64                        m_MinuteBegin; // Epoch second the cached prefix starts at.
+    };
+
+}
@@ -1,4 +1,6 @@
 #pragma once
+#include <bit>
+#include <concepts>
 #include <filesystem>
 
 namespace aby {
@@ -23,6 +25,16 @@ namespace aby {
     template <typename T>
     using Weak = std::weak_ptr<T>;
 
+    // value in little-endian byte order, the order of the binary log and profile formats. Its own inverse.
+    template <std::integral T>
+    constexpr T to_little_endian(T value) {
+        if constexpr (std::endian::native == std::endian::big && sizeof(T) > 1) {
+            return std::byteswap(value);
+        } else {
+            return value;
+        }
+    }
+
     template <typename T, typename... Args>
     Ref<T> create_ref(Args&&... args) {
         return std::make_shared<T>(std::forward<Args>(args)...);
@@ -1,7 +1,17 @@
 #pragma once
 #include "Log.h"
+#include "Macros.h"
 #include <map>
+#include <memory>
+#include <memory_resource>
+#include <vector>
 #include <iostream>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <cstdint>
 #include <type_traits>
 
 namespace aby::containers {
@@ -11,13 +21,143 @@ namespace aby::containers {
     template <typename K, typename V>
     concept CBiMap = !std::is_same_v<K, V> && std::is_default_constructible_v<K> && std::is_default_constructible_v<V>;
 
-    template <typename K, typename V> requires(CBiMap<K, V>)
+    template <typename T>
+    concept CHashable = requires(const T& t) { { std::hash<T>{}(t) } -> std::convertible_to<std::size_t>; } && std::equality_comparable<T>;
+
+    template <typename T>
+    struct is_char_string : std::false_type {};
+
+    template <typename A>
+    struct is_char_string<std::basic_string<char, std::char_traits<char>, A>> : std::true_type {};
+
+    // Sides that compare by content (std::string with any allocator, std::string_view), so any
+    // string-like argument can look them up as a string_view.
+    template <typename T>
+    concept CStringKey = is_char_string<T>::value || std::is_same_v<T, std::string_view>;
+
+    template <typename T>
+    concept CStringLike = std::is_convertible_v<const T&, std::string_view>;
+
+    /**
+    * @brief KV can look up a side holding T: the same type, a string-like for a string side,
+    *        or something implicitly convertible to T.
+    */
+    template <typename KV, typename T>
+    concept CLookupFor = std::is_same_v<KV, T> || (CStringKey<T> && CStringLike<KV>) || std::is_convertible_v<const KV&, T>;
+
+    /**
+    * @brief Side a lookup with KV goes to. An exact type match wins, otherwise exactly one side may
+    *        accept KV. If both (or neither) do it's a compile error, use left()/right() instead.
+    */
+    template <typename KV, typename K, typename V>
+    consteval auto lookup_side() -> EBiMapSide {
+        if constexpr (std::is_same_v<KV, K>) {
+            return EBiMapSide::Left;
+        } else if constexpr (std::is_same_v<KV, V>) {
+            return EBiMapSide::Right;
+        } else {
+            static_assert(CLookupFor<KV, K> != CLookupFor<KV, V>, "BiMap: ambiguous lookup type, use left() or right()");
+            return CLookupFor<KV, K> ? EBiMapSide::Left : EBiMapSide::Right;
+        }
+    }
+
+    // The argument as the index sees it. String-likes stay a string_view, so lookups don't build a std::string.
+    template <typename T, typename KV>
+    constexpr auto lookup_key(const KV& kv) -> decltype(auto) {
+        if constexpr (CStringKey<T> && CStringLike<KV>)
+            return std::string_view(kv);
+        else if constexpr (std::is_same_v<KV, T>)
+            return (kv);
+        else
+            return static_cast<T>(kv);
+    }
+
+    // Missing-entry messages show the argument when std::format can print it (enums can't).
+    template <typename T>
+    constexpr auto printable(const T& value) -> decltype(auto) {
+        if constexpr (requires { std::formatter<std::remove_cvref_t<T>, char>(); })
+            return (value);
+        else
+            return std::string_view("<unprintable>");
+    }
+
+    /**
+    * @brief Transparent hash for one BiMap side, std::string and anything string-like hash the same.
+    */
+    template <typename T>
+    struct BiMapHash {
+        using is_transparent = void;
+
+        template <typename U>
+        auto operator()(const U& value) const -> std::size_t {
+            if constexpr (CStringKey<T>)
+                return std::hash<std::string_view>{}(std::string_view(value));
+            else
+                return std::hash<T>{}(value);
+        }
+    };
+
+    /**
+    * @brief Storage policies for BiMap.
+    *        OrderedPolicy:  two std::maps, ordered iteration, O(log n) both ways.
+    *        FlatHashPolicy: each pair stored once in a contiguous array, indexed from both sides
+    *                        by open-addressing hash tables. O(1) both ways, iteration in storage order.
+    */
+    struct OrderedPolicy {};
+    struct FlatHashPolicy {};
+
+    /*
+    * Both policies take an allocator for std::pair<const K, V> and rebind it for their nodes, pair
+    * arrays and slot tables. With pmr::BiMap on an aby::Arena or aby::NodePool (Allocators.h) every
+    * allocation stays on the owning thread's resource and tearing a whole map down is a reset() of
+    * the resource instead of a free per node.
+    */
+
+    /**
+    * @brief Lookups on one side of a BiMap (see BiMap::left()/right()).
+    *        The direction is fixed by the view, never guessed from the argument type.
+    *        Map is const for views of a const BiMap, erase() is only available otherwise.
+    */
+    template <typename Map, EBiMapSide Side>
+    class BiMapView {
+    public:
+        using lookup_type = std::conditional_t<Side == EBiMapSide::Left, typename Map::key_type, typename Map::mapped_type>;
+        using result_type = std::conditional_t<Side == EBiMapSide::Left, typename Map::mapped_type, typename Map::key_type>;
+
+        constexpr explicit BiMapView(Map& map) : m_Map(map) {}
+
+        template <typename L> requires(CLookupFor<L, lookup_type>)
+        constexpr auto at(const L& key) const -> const result_type& { return m_Map.template at_on<Side>(key); }
+
+        template <typename L> requires(CLookupFor<L, lookup_type>)
+        constexpr bool contains(const L& key) const { return m_Map.template contains_on<Side>(key); }
+
+        template <typename L> requires(CLookupFor<L, lookup_type> && !std::is_const_v<Map>)
+        bool erase(const L& key) const { return m_Map.template erase_on<Side>(key); }
+
+    private:
+        Map& m_Map;
+    };
+
+    template <typename K, typename V, typename Policy = OrderedPolicy, typename Alloc = std::allocator<std::pair<const K, V>>> requires(CBiMap<K, V>)
     class BiMap {
+        template <typename, EBiMapSide> friend class BiMapView;
+
+        template <typename T>
+        using alloc_t = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
     public:
         using key_type = K;
         using mapped_type = V;
         using size_type = std::size_t;
-        using iterator = typename std::map<K, V>::const_iterator;
+        using allocator_type = Alloc;
+        using left_map_type = std::map<K, V, std::less<>, alloc_t<std::pair<const K, V>>>;
+        using right_map_type = std::map<V, K, std::less<>, alloc_t<std::pair<const V, K>>>;
+        using iterator = typename left_map_type::const_iterator;
+
+        BiMap() = default;
+        explicit BiMap(const Alloc& alloc) : m_Fwd(alloc), m_Rev(alloc) {}
+
+        allocator_type get_allocator() const { return allocator_type(m_Fwd.get_allocator()); }
 
         iterator begin() const { return m_Fwd.cbegin(); }
         iterator end() const { return m_Fwd.cend(); }
@@ -33,75 +173,17 @@ namespace aby::containers {
 
         template <typename KV>
         auto at(const KV& kv) const -> const auto& {
-        #ifndef NDEBUG
-            if constexpr (std::is_same_v<KV, K> || std::is_convertible_v<KV, K>) {
-                if (!m_Fwd.count(kv)) {
-                    log_err("BiMap::at: Key not found: {}", kv);
-                    static V dv{};
-                    return dv; // fallback value for missing key
-                }
-                return m_Fwd.at(kv);
-            } else if constexpr (std::is_same_v<KV, V> || std::is_convertible_v<KV, V>) {
-                if (!m_Rev.count(kv)) {
-                    log_err("BiMap::at: Value not found: {}", kv);
-                    static K dk{};
-                    return dk; // fallback value for missing value
-                }
-                return m_Rev.at(kv);
-            } else {
-                static_assert(std::is_same_v<KV, K> || std::is_same_v<KV, V>, "Type must be K or V");
-            }
-        #else
-            if constexpr (std::is_same_v<KV, K> || std::is_convertible_v<KV, K>)
-                return m_Fwd.at(kv);
-            else if constexpr (std::is_same_v<KV, V> || std::is_convertible_v<KV, V>)
-                return m_Rev.at(kv);
-        #endif
+            return at_on<lookup_side<KV, K, V>()>(kv);
         }
 
-
         template <typename KV>
         bool contains(const KV& kv) const {
-            if constexpr (std::is_same_v<KV, K> || std::is_convertible_v<KV, K>) {
-                return m_Fwd.count(kv) > 0;
-            } else if constexpr (std::is_same_v<KV, V> || std::is_convertible_v<KV, V>) {
-                return m_Rev.count(kv) > 0;
-            } else {
-                static_assert(std::is_same_v<KV, K> || std::is_same_v<KV, V>, "Type must be K or V");
-            }
+            return contains_on<lookup_side<KV, K, V>()>(kv);
         }
 
         template <typename KV>
         bool erase(const KV& kv) {
-            if constexpr (std::is_same_v<KV, K> || std::is_convertible_v<KV, K>) {
-                auto it = m_Fwd.find(kv);
-                if (it == m_Fwd.end()) {
-        #ifndef NDEBUG
-                    log_warn("BiMap::erase: Key not found: {}", kv);
-                    return false;
-        #else
-                    return false;
-        #endif
-                }
-                m_Rev.erase(it->second);
-                m_Fwd.erase(it);
-                return true;
-            } else if constexpr (std::is_same_v<KV, V> || std::is_convertible_v<KV, V>) {
-                auto it = m_Rev.find(kv);
-                if (it == m_Rev.end()) {
-        #ifndef NDEBUG
-                    log_warn("BiMap::erase: Value not found: {}", kv);
-                    return false;
-        #else
-                    return false;
-        #endif
-                }
-                m_Fwd.erase(it->second);
-                m_Rev.erase(it);
-                return true;
-            } else {
-                static_assert(std::is_same_v<KV, K> || std::is_same_v<KV, V>, "Type must be K or V");
-            }
+            return erase_on<lookup_side<KV, K, V>()>(kv);
         }
 
         V& operator[](const K& k) {
@@ -112,6 +194,11 @@ namespace aby::containers {
             return m_Rev[v];
         }
 
+        auto left() const -> BiMapView<const BiMap, EBiMapSide::Left> { return BiMapView<const BiMap, EBiMapSide::Left>(*this); }
+        auto left() -> BiMapView<BiMap, EBiMapSide::Left> { return BiMapView<BiMap, EBiMapSide::Left>(*this); }
+        auto right() const -> BiMapView<const BiMap, EBiMapSide::Right> { return BiMapView<const BiMap, EBiMapSide::Right>(*this); }
+        auto right() -> BiMapView<BiMap, EBiMapSide::Right> { return BiMapView<BiMap, EBiMapSide::Right>(*this); }
+
         void print(std::ostream& os = std::cout, EBiMapSide side = EBiMapSide::Left) const {
             os << "[\n    "; // opening bracket with initial indent
             int count = 0;
@@ -140,11 +227,311 @@ namespace aby::containers {
         bool empty() const { return m_Fwd.empty(); }
         void clear() { m_Fwd.clear(); m_Rev.clear(); }
 
-        const std::map<K, V>& left_map() const { return m_Fwd; }
-        const std::map<V, K>& right_map() const { return m_Rev; }
+        const left_map_type& left_map() const { return m_Fwd; }
+        const right_map_type& right_map() const { return m_Rev; }
+
+    private:
+        template <EBiMapSide Side>
+        using side_t = std::conditional_t<Side == EBiMapSide::Left, K, V>;
+
+        template <EBiMapSide Side>
+        auto index() const -> const auto& {
+            if constexpr (Side == EBiMapSide::Left) return m_Fwd;
+            else                                    return m_Rev;
+        }
+
+        template <EBiMapSide Side>
+        auto index() -> auto& {
+            if constexpr (Side == EBiMapSide::Left) return m_Fwd;
+            else                                    return m_Rev;
+        }
+
+        template <EBiMapSide Side, typename KV>
+        auto at_on(const KV& kv) const -> const auto& {
+            const auto& map = index<Side>();
+            auto it = map.find(lookup_key<side_t<Side>>(kv));
+            if (it == map.end()) {
+        #ifndef NDEBUG
+                log_err("BiMap::at: {} not found: {}", Side == EBiMapSide::Left ? "Key" : "Value", printable(kv));
+                static typename std::remove_cvref_t<decltype(map)>::mapped_type fallback{};
+                return fallback; // fallback for a missing key/value
+        #else
+                throw std::out_of_range(Side == EBiMapSide::Left ? "BiMap::at: key not found" : "BiMap::at: value not found");
+        #endif
+            }
+            return it->second;
+        }
+
+        template <EBiMapSide Side, typename KV>
+        bool contains_on(const KV& kv) const {
+            return index<Side>().contains(lookup_key<side_t<Side>>(kv));
+        }
+
+        template <EBiMapSide Side, typename KV>
+        bool erase_on(const KV& kv) {
+            auto& map = index<Side>();
+            auto it = map.find(lookup_key<side_t<Side>>(kv));
+            if (it == map.end()) {
+        #ifndef NDEBUG
+                log_warn("BiMap::erase: {} not found: {}", Side == EBiMapSide::Left ? "Key" : "Value", printable(kv));
+        #endif
+                return false;
+            }
+            index<Side == EBiMapSide::Left ? EBiMapSide::Right : EBiMapSide::Left>().erase(it->second);
+            map.erase(it);
+            return true;
+        }
+
+    private:
+        left_map_type  m_Fwd;
+        right_map_type m_Rev;
+    };
+
+    /**
+    * @brief BiMap with FlatHashPolicy.
+    *        Pairs live in one vector (erase moves the last pair into the hole), each side has a
+    *        linear-probing table of { entry index, 32-bit hash } slots kept at most 3/4 full, so a
+    *        pair costs sizeof(K) + sizeof(V) plus roughly 16-32 bytes of index.
+    *        operator[] is lookup only here: handing out a mutable reference would let the caller
+    *        change a side without the index noticing.
+    */
+    template <typename K, typename V, typename Alloc> requires(CBiMap<K, V>)
+    class BiMap<K, V, FlatHashPolicy, Alloc> {
+        static_assert(CHashable<K> && CHashable<V>, "FlatHashPolicy needs std::hash and operator== for both sides");
+        template <typename, EBiMapSide> friend class BiMapView;
+
+        template <typename T>
+        using alloc_t = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+        struct Slot;
+        using slot_vector = std::vector<Slot, alloc_t<Slot>>;
+    public:
+        using key_type       = K;
+        using mapped_type    = V;
+        using value_type     = std::pair<K, V>;
+        using size_type      = std::size_t;
+        using allocator_type = Alloc;
+        using iterator       = typename std::vector<value_type, alloc_t<value_type>>::const_iterator;
+
+        BiMap() = default;
+        explicit BiMap(const Alloc& alloc) : m_Entries(alloc), m_Left(alloc), m_Right(alloc) {}
+
+        allocator_type get_allocator() const { return allocator_type(m_Entries.get_allocator()); }
+
+        iterator begin() const { return m_Entries.cbegin(); }
+        iterator end() const { return m_Entries.cend(); }
+
+        bool insert(const K& k, const V& v) {
+            u64 left_hash  = hash_of<K>(k);
+            u64 right_hash = hash_of<V>(v);
+            if (find<EBiMapSide::Left>(k, left_hash) != npos || find<EBiMapSide::Right>(v, right_hash) != npos)
+                return false;
+
+            if (m_Entries.size() + 1 > max_load(m_Left.size()))
+                rehash(std::max<size_type>(min_slots, m_Left.size() * 2));
+
+            m_Entries.emplace_back(k, v);
+            auto entry = static_cast<u32>(m_Entries.size());
+            place(m_Left, entry, static_cast<u32>(left_hash));
+            place(m_Right, entry, static_cast<u32>(right_hash));
+            return true;
+        }
+
+        template <typename KV>
+        auto at(const KV& kv) const -> const auto& {
+            return at_on<lookup_side<KV, K, V>()>(kv);
+        }
+
+        template <typename KV>
+        bool contains(const KV& kv) const {
+            return contains_on<lookup_side<KV, K, V>()>(kv);
+        }
+
+        template <typename KV>
+        bool erase(const KV& kv) {
+            return erase_on<lookup_side<KV, K, V>()>(kv);
+        }
+
+        const V& operator[](const K& k) const {
+            return at_on<EBiMapSide::Left>(k);
+        }
+
+        const K& operator[](const V& v) const {
+            return at_on<EBiMapSide::Right>(v);
+        }
+
+        auto left() const -> BiMapView<const BiMap, EBiMapSide::Left> { return BiMapView<const BiMap, EBiMapSide::Left>(*this); }
+        auto left() -> BiMapView<BiMap, EBiMapSide::Left> { return BiMapView<BiMap, EBiMapSide::Left>(*this); }
+        auto right() const -> BiMapView<const BiMap, EBiMapSide::Right> { return BiMapView<const BiMap, EBiMapSide::Right>(*this); }
+        auto right() -> BiMapView<BiMap, EBiMapSide::Right> { return BiMapView<BiMap, EBiMapSide::Right>(*this); }
+
+        void print(std::ostream& os = std::cout, EBiMapSide side = EBiMapSide::Left) const {
+            os << "[\n    "; // opening bracket with initial indent
+            int count = 0;
+            for (const auto& [k, v] : m_Entries) {
+                if (count > 0) os << ", ";
+                if (side == EBiMapSide::Left) os << "(" << k << ", " << v << ")";
+                else                          os << "(" << v << ", " << k << ")";
+                ++count;
+                if (count % 8 == 0) os << "\n    "; // newline + indent after 8 pairs
+            }
+            os << "\n]\n"; // final newline after closing bracket
+        }
+
+        // Make room for n pairs without rehashing.
+        void reserve(size_type n) {
+            m_Entries.reserve(n);
+            size_type slots = min_slots;
+            while (max_load(slots) < n) slots *= 2;
+            if (slots > m_Left.size()) rehash(slots);
+        }
+
+        size_type size() const { return m_Entries.size(); }
+        bool empty() const { return m_Entries.empty(); }
+        void clear() { m_Entries.clear(); m_Left.clear(); m_Right.clear(); }
+
+    private:
+        struct Slot {
+            u32 entry = 0; // 1-based index into m_Entries, 0 = empty.
+            u32 hash  = 0; // Low bits pick the home slot, all 32 filter compares.
+        };
+
+        static constexpr size_type npos      = static_cast<size_type>(-1);
+        static constexpr size_type min_slots = 16;
+
+        template <EBiMapSide Side>
+        using side_t = std::conditional_t<Side == EBiMapSide::Left, K, V>;
+
+        static constexpr auto other(EBiMapSide side) -> EBiMapSide {
+            return side == EBiMapSide::Left ? EBiMapSide::Right : EBiMapSide::Left;
+        }
+
+        static auto max_load(size_type slots) -> size_type { return slots - slots / 4; }
+
+        template <typename T, typename Key>
+        static auto hash_of(const Key& key) -> u64 {
+            // std::hash is the identity for integers, finish it so consecutive ids spread over the table.
+            u64 x = static_cast<u64>(BiMapHash<T>{}(key));
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccdULL;
+            x ^= x >> 33;
+            return x;
+        }
+
+        template <EBiMapSide Side>
+        auto table() const -> const slot_vector& { return Side == EBiMapSide::Left ? m_Left : m_Right; }
+
+        template <EBiMapSide Side>
+        static auto side_of(const value_type& pair) -> const side_t<Side>& {
+            if constexpr (Side == EBiMapSide::Left) return pair.first;
+            else                                    return pair.second;
+        }
+
+        template <EBiMapSide Side, typename Key>
+        auto find(const Key& key, u64 hash) const -> size_type {
+            const auto& slots = table<Side>();
+            if (slots.empty())
+                return npos;
+            size_type mask = slots.size() - 1;
+            auto tag = static_cast<u32>(hash);
+            for (size_type i = tag & mask;; i = (i + 1) & mask) {
+                const Slot& slot = slots[i];
+                if (!slot.entry)
+                    return npos;
+                if (slot.hash == tag && side_of<Side>(m_Entries[slot.entry - 1]) == key)
+                    return i;
+            }
+        }
+
+        template <EBiMapSide Side, typename KV>
+        auto at_on(const KV& kv) const -> const side_t<other(Side)>& {
+            const auto& key = lookup_key<side_t<Side>>(kv);
+            auto slot = find<Side>(key, hash_of<side_t<Side>>(key));
+            if (slot == npos) {
+        #ifndef NDEBUG
+                log_err("BiMap::at: {} not found: {}", Side == EBiMapSide::Left ? "Key" : "Value", printable(kv));
+                static side_t<other(Side)> fallback{};
+                return fallback; // fallback for a missing key/value
+        #else
+                throw std::out_of_range(Side == EBiMapSide::Left ? "BiMap::at: key not found" : "BiMap::at: value not found");
+        #endif
+            }
+            return side_of<other(Side)>(m_Entries[table<Side>()[slot].entry - 1]);
+        }
+
+        template <EBiMapSide Side, typename KV>
+        bool contains_on(const KV& kv) const {
+            const auto& key = lookup_key<side_t<Side>>(kv);
+            return find<Side>(key, hash_of<side_t<Side>>(key)) != npos;
+        }
+
+        template <EBiMapSide Side, typename KV>
+        bool erase_on(const KV& kv) {
+            const auto& key = lookup_key<side_t<Side>>(kv);
+            size_type slot = find<Side>(key, hash_of<side_t<Side>>(key));
+            if (slot == npos) {
+        #ifndef NDEBUG
+                log_warn("BiMap::erase: {} not found: {}", Side == EBiMapSide::Left ? "Key" : "Value", printable(kv));
+        #endif
+                return false;
+            }
+            u32 entry = table<Side>()[slot].entry;
+            const auto& pair = m_Entries[entry - 1];
+            size_type left_slot  = Side == EBiMapSide::Left ? slot : find<EBiMapSide::Left>(pair.first, hash_of<K>(pair.first));
+            size_type right_slot = Side == EBiMapSide::Right ? slot : find<EBiMapSide::Right>(pair.second, hash_of<V>(pair.second));
+            remove(m_Left, left_slot);
+            remove(m_Right, right_slot);
+
+            // Keep the array dense: the last pair takes the hole and its slots are pointed at it.
+            auto last = static_cast<u32>(m_Entries.size());
+            if (entry != last) {
+                auto& moved = m_Entries[last - 1];
+                m_Left[find<EBiMapSide::Left>(moved.first, hash_of<K>(moved.first))].entry     = entry;
+                m_Right[find<EBiMapSide::Right>(moved.second, hash_of<V>(moved.second))].entry = entry;
+                m_Entries[entry - 1] = std::move(moved);
+            }
+            m_Entries.pop_back();
+            return true;
+        }
+
+        static void place(slot_vector& slots, u32 entry, u32 hash) {
+            size_type mask = slots.size() - 1;
+            size_type i = hash & mask;
+            while (slots[i].entry)
+                i = (i + 1) & mask;
+            slots[i] = { entry, hash };
+        }
+
+        // Backward-shift deletion, linear probing needs no tombstones this way.
+        static void remove(slot_vector& slots, size_type i) {
+            size_type mask = slots.size() - 1;
+            for (size_type j = (i + 1) & mask; slots[j].entry; j = (j + 1) & mask) {
+                size_type home = slots[j].hash & mask;
+                if (((j - home) & mask) >= ((j - i) & mask)) {
+                    slots[i] = slots[j];
+                    i = j;
+                }
+            }
+            slots[i] = {};
+        }
+
+        void rehash(size_type count) {
+            for (auto* slots : { &m_Left, &m_Right }) {
+                slot_vector old(count, slots->get_allocator());
+                old.swap(*slots);
+                for (const Slot& slot : old)
+                    if (slot.entry) place(*slots, slot.entry, slot.hash);
+            }
+        }
 
     private:
-        std::map<K, V> m_Fwd;
-        std::map<V, K> m_Rev;
+        std::vector<value_type, alloc_t<value_type>> m_Entries;
+        slot_vector                                  m_Left;
+        slot_vector                                  m_Right;
     };
+
+    namespace pmr {
+        // BiMap on a std::pmr::memory_resource, e.g. pmr::BiMap<int, std::pmr::string> map(&arena);
+        template <typename K, typename V, typename Policy = OrderedPolicy>
+        using BiMap = containers::BiMap<K, V, Policy, std::pmr::polymorphic_allocator<std::pair<const K, V>>>;
+    }
 }
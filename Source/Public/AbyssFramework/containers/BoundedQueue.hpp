@@ -0,0 +1,110 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <bit>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace aby::containers {
+
+    /**
+    * @brief Bounded lock-free multi-producer/multi-consumer ring buffer.
+    *        Each cell carries a sequence number (Vyukov), so producers only contend on the
+    *        enqueue position and consumers on the dequeue position. No locks, no allocations
+    *        after construction. Capacity is rounded up to the next power of two.
+    */
+    template <typename T>
+    class BoundedQueue {
+    public:
+        using value_type = T;
+        using size_type  = std::size_t;
+
+        explicit BoundedQueue(size_type capacity) :
+            m_Mask(std::bit_ceil(std::max<size_type>(capacity, 2)) - 1),
+            m_Cells(std::make_unique<Cell[]>(m_Mask + 1))
+        {
+            for (size_type i = 0; i <= m_Mask; ++i) {
+                m_Cells[i].seq.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        /**
+        * @brief  Push a value if there is a free cell.
+        * @return False if the queue is full, value is left untouched in that case.
+        */
+        bool try_push(T&& value) {
+            Cell* cell = nullptr;
+            size_type pos = m_EnqueuePos.load(std::memory_order_relaxed);
+            while (true) {
+                cell = &m_Cells[pos & m_Mask];
+                size_type seq = cell->seq.load(std::memory_order_acquire);
+                auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+                if (diff == 0) {
+                    if (m_EnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = m_EnqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+            cell->data = std::move(value);
+            cell->seq.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+        * @brief  Pop the oldest value.
+        * @return False if the queue is empty.
+        */
+        bool try_pop(T& out) {
+            Cell* cell = nullptr;
+            size_type pos = m_DequeuePos.load(std::memory_order_relaxed);
+            while (true) {
+                cell = &m_Cells[pos & m_Mask];
+                size_type seq = cell->seq.load(std::memory_order_acquire);
+                auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+                if (diff == 0) {
+                    if (m_DequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = m_DequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+            out = std::move(cell->data);
+            cell->seq.store(pos + m_Mask + 1, std::memory_order_release);
+            return true;
+        }
+
+        size_type capacity() const { return m_Mask + 1; }
+
+        // Only a snapshot, may be stale by the time it's used.
+        size_type size_approx() const {
+            size_type head = m_DequeuePos.load(std::memory_order_relaxed);
+            size_type tail = m_EnqueuePos.load(std::memory_order_relaxed);
+            return tail > head ? tail - head : 0;
+        }
+
+        bool empty_approx() const { return size_approx() == 0; }
+
+    private:
+        static constexpr size_type cache_line = 64;
+
+        struct Cell {
+            std::atomic<size_type> seq;
+            T                      data;
+        };
+
+        const size_type         m_Mask;
+        std::unique_ptr<Cell[]> m_Cells;
+        alignas(cache_line) std::atomic<size_type> m_EnqueuePos{ 0 };
+        alignas(cache_line) std::atomic<size_type> m_DequeuePos{ 0 };
+    };
+
+}
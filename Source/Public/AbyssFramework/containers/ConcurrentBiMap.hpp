@@ -0,0 +1,149 @@
+#pragma once
+#include "BiMap.hpp"
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace aby::containers {
+
+    /**
+    * @brief BiMap shared between threads, for read-mostly tables (symbol/protocol name <-> id).
+    *        Left-right concurrency control: two full copies, readers use the active one, a writer
+    *        edits the inactive copy, flips it active, waits for readers still on the old one and
+    *        replays the edit there. Readers never lock or retry, and both sides of a pair are in
+    *        the same copy, so an insert/erase is seen whole from either side or not at all.
+    *        Readers only touch their own cache line (one of reader_slots read counters), so
+    *        lookups scale with the number of threads. Writers are serialized and pay for two edits.
+    *        Lookups return copies, references into a copy would not survive the next write.
+    *        Only writers allocate, under the write lock, so a non-locking Arena/NodePool is fine as
+    *        long as it outlives the map.
+    */
+    template <typename K, typename V, typename Policy = FlatHashPolicy, typename Alloc = std::allocator<std::pair<const K, V>>> requires(CBiMap<K, V>)
+    class ConcurrentBiMap {
+    public:
+        using map_type  = BiMap<K, V, Policy, Alloc>;
+        using size_type = typename map_type::size_type;
+
+        static constexpr std::size_t reader_slots = 128;
+
+        ConcurrentBiMap() = default;
+        explicit ConcurrentBiMap(const Alloc& alloc) : m_Maps{ map_type(alloc), map_type(alloc) } {}
+        ConcurrentBiMap(const ConcurrentBiMap&) = delete;
+        ConcurrentBiMap& operator=(const ConcurrentBiMap&) = delete;
+
+        /**
+        * @brief Run fn(const map_type&) against a consistent snapshot, for several lookups in one go.
+        *        fn must not write to this map, the write would wait for fn to finish.
+        */
+        template <typename Fn>
+        auto read(Fn&& fn) const -> decltype(auto) {
+            ReadGuard guard(*this);
+            return std::forward<Fn>(fn)(m_Maps[m_Active.load(std::memory_order_seq_cst)]);
+        }
+
+        template <typename KV>
+        bool contains(const KV& kv) const {
+            return read([&](const map_type& map) { return map.contains(kv); });
+        }
+
+        // Same lookup rules (and missing-entry behaviour) as BiMap::at, but returns a copy.
+        template <typename KV>
+        auto at(const KV& kv) const {
+            return read([&](const map_type& map) { return std::remove_cvref_t<decltype(map.at(kv))>(map.at(kv)); });
+        }
+
+        // at() without the missing-entry handling: empty if kv isn't there.
+        template <typename KV>
+        auto find(const KV& kv) const {
+            return read([&](const map_type& map) -> std::optional<std::remove_cvref_t<decltype(map.at(kv))>> {
+                if (!map.contains(kv))
+                    return std::nullopt;
+                return map.at(kv);
+            });
+        }
+
+        size_type size() const {
+            return read([](const map_type& map) { return map.size(); });
+        }
+
+        bool empty() const { return size() == 0; }
+
+        bool insert(const K& k, const V& v) {
+            return write([&](map_type& map) { return map.insert(k, v); });
+        }
+
+        template <typename KV>
+        bool erase(const KV& kv) {
+            return write([&](map_type& map) { return map.erase(kv); });
+        }
+
+        void clear() {
+            write([](map_type& map) { map.clear(); return true; });
+        }
+
+    private:
+        struct alignas(64) ReaderSlot {
+            std::array<std::atomic<u32>, 2> readers{};
+        };
+
+        // Threads get consecutive slots, so up to reader_slots threads never share a counter.
+        static auto reader_slot() -> std::size_t {
+            static std::atomic<std::size_t> next{ 0 };
+            thread_local std::size_t slot = next.fetch_add(1, std::memory_order_relaxed) % reader_slots;
+            return slot;
+        }
+
+        class ReadGuard {
+        public:
+            explicit ReadGuard(const ConcurrentBiMap& map) :
+                m_Counter(map.m_Slots[reader_slot()].readers[map.m_Version.load(std::memory_order_seq_cst)])
+            {
+                m_Counter.fetch_add(1, std::memory_order_seq_cst);
+            }
+            ~ReadGuard() { m_Counter.fetch_sub(1, std::memory_order_release); }
+
+            ReadGuard(const ReadGuard&) = delete;
+            ReadGuard& operator=(const ReadGuard&) = delete;
+        private:
+            std::atomic<u32>& m_Counter;
+        };
+
+        template <typename Fn>
+        bool write(Fn&& fn) {
+            std::lock_guard lock(m_WriteMutex);
+            u32 active = m_Active.load(std::memory_order_relaxed);
+            bool result = fn(m_Maps[active ^ 1]);
+            if (!result)
+                return false; // Nothing changed, both copies are still equal.
+
+            m_Active.store(active ^ 1, std::memory_order_seq_cst);
+
+            // Readers that arrived before the flip may still be on the old copy. Move new arrivals
+            // to the other counter, then wait for both counters to drain before touching it.
+            u32 version = m_Version.load(std::memory_order_relaxed);
+            wait_for_readers(version ^ 1);
+            m_Version.store(version ^ 1, std::memory_order_seq_cst);
+            wait_for_readers(version);
+
+            fn(m_Maps[active]);
+            return true;
+        }
+
+        void wait_for_readers(u32 version) const {
+            for (const auto& slot : m_Slots) {
+                while (slot.readers[version].load(std::memory_order_acquire) != 0) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+    private:
+        std::array<map_type, 2>                      m_Maps;
+        alignas(64) std::atomic<u32>                 m_Active{ 0 };
+        std::atomic<u32>                             m_Version{ 0 };
+        std::mutex                                   m_WriteMutex;
+        mutable std::array<ReaderSlot, reader_slots> m_Slots; // Read counters, written by const lookups.
+    };
+}
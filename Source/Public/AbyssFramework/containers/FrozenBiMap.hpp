@@ -0,0 +1,179 @@
+#pragma once
+#include "BiMap.hpp"
+#include <algorithm>
+#include <array>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace aby::containers {
+
+    /**
+    * @brief Read-only BiMap built in one go, for tables that are filled at startup and then only read.
+    *        Pairs are sorted by key in one contiguous array, a second array of u32 indices orders
+    *        them by value, lookups are binary searches. That's sizeof(K) + sizeof(V) + 4 bytes per
+    *        pair, against two tree nodes per pair for OrderedPolicy.
+    *        N fixes the size at compile time (std::array storage), so small tables can be constexpr,
+    *        see make_frozen_bimap(). With the default dynamic extent the arrays are std::vectors.
+    *        Duplicates on either side throw std::invalid_argument (a compile error in constexpr).
+    *        Same lookup rules as BiMap (transparent, left()/right() views), iteration is by key.
+    */
+    template <typename K, typename V, std::size_t N = std::dynamic_extent> requires(CBiMap<K, V>)
+    class FrozenBiMap {
+        template <typename, EBiMapSide> friend class BiMapView;
+
+        template <typename T>
+        using storage_t = std::conditional_t<N == std::dynamic_extent, std::vector<T>, std::array<T, N>>;
+    public:
+        using key_type    = K;
+        using mapped_type = V;
+        using value_type  = std::pair<K, V>;
+        using size_type   = std::size_t;
+        using iterator    = typename storage_t<value_type>::const_iterator;
+
+        constexpr FrozenBiMap() requires(N == std::dynamic_extent || N == 0) = default;
+
+        /**
+        * @brief Build from a range of pair-likes ([k, v] structured bindings), e.g. a vector of
+        *        pairs or another BiMap. A fixed-size map needs exactly N of them.
+        */
+        template <std::ranges::input_range R>
+            requires(!std::is_same_v<std::remove_cvref_t<R>, FrozenBiMap>)
+        constexpr explicit FrozenBiMap(R&& pairs) {
+            if constexpr (N == std::dynamic_extent) {
+                if constexpr (std::ranges::sized_range<R>)
+                    m_Entries.reserve(std::ranges::size(pairs));
+                for (const auto& [k, v] : pairs)
+                    m_Entries.emplace_back(k, v);
+                m_ByValue.resize(m_Entries.size());
+            } else {
+                size_type count = 0;
+                for (const auto& [k, v] : pairs) {
+                    if (count == N)
+                        throw std::invalid_argument("FrozenBiMap: more pairs than N");
+                    m_Entries[count++] = value_type(k, v);
+                }
+                if (count != N)
+                    throw std::invalid_argument("FrozenBiMap: fewer pairs than N");
+            }
+            build();
+        }
+
+        constexpr iterator begin() const { return m_Entries.cbegin(); }
+        constexpr iterator end() const { return m_Entries.cend(); }
+
+        template <typename KV>
+        constexpr auto at(const KV& kv) const -> const auto& {
+            return at_on<lookup_side<KV, K, V>()>(kv);
+        }
+
+        template <typename KV>
+        constexpr bool contains(const KV& kv) const {
+            return contains_on<lookup_side<KV, K, V>()>(kv);
+        }
+
+        constexpr const V& operator[](const K& k) const {
+            return at_on<EBiMapSide::Left>(k);
+        }
+
+        constexpr const K& operator[](const V& v) const {
+            return at_on<EBiMapSide::Right>(v);
+        }
+
+        constexpr auto left() const -> BiMapView<const FrozenBiMap, EBiMapSide::Left> { return BiMapView<const FrozenBiMap, EBiMapSide::Left>(*this); }
+        constexpr auto right() const -> BiMapView<const FrozenBiMap, EBiMapSide::Right> { return BiMapView<const FrozenBiMap, EBiMapSide::Right>(*this); }
+
+        constexpr size_type size() const { return m_Entries.size(); }
+        constexpr bool empty() const { return m_Entries.empty(); }
+
+    private:
+        template <EBiMapSide Side>
+        using side_t = std::conditional_t<Side == EBiMapSide::Left, K, V>;
+
+        static constexpr auto other(EBiMapSide side) -> EBiMapSide {
+            return side == EBiMapSide::Left ? EBiMapSide::Right : EBiMapSide::Left;
+        }
+
+        constexpr void build() {
+            std::ranges::sort(m_Entries, std::less<>{}, &value_type::first);
+            for (size_type i = 0; i < m_ByValue.size(); ++i)
+                m_ByValue[i] = static_cast<u32>(i);
+            std::ranges::sort(m_ByValue, std::less<>{}, [this](u32 i) -> const V& { return m_Entries[i].second; });
+
+            // Sorted, so any duplicate sits next to its twin.
+            for (size_type i = 1; i < m_Entries.size(); ++i) {
+                if (!(m_Entries[i - 1].first < m_Entries[i].first))
+                    throw std::invalid_argument("FrozenBiMap: duplicate key");
+                if (!(m_Entries[m_ByValue[i - 1]].second < m_Entries[m_ByValue[i]].second))
+                    throw std::invalid_argument("FrozenBiMap: duplicate value");
+            }
+        }
+
+        // Position in m_Entries of the pair whose Side equals key, or size() if there is none.
+        template <EBiMapSide Side, typename Key>
+        constexpr auto find(const Key& key) const -> size_type {
+            if constexpr (Side == EBiMapSide::Left) {
+                auto it = std::ranges::lower_bound(m_Entries, key, std::less<>{}, &value_type::first);
+                return it != m_Entries.end() && !std::less<>{}(key, it->first) ? static_cast<size_type>(it - m_Entries.begin()) : size();
+            } else {
+                auto it = std::ranges::lower_bound(m_ByValue, key, std::less<>{}, [this](u32 i) -> const V& { return m_Entries[i].second; });
+                return it != m_ByValue.end() && !std::less<>{}(key, m_Entries[*it].second) ? *it : size();
+            }
+        }
+
+        template <EBiMapSide Side, typename KV>
+        constexpr auto at_on(const KV& kv) const -> const side_t<other(Side)>& {
+            size_type i = find<Side>(lookup_key<side_t<Side>>(kv));
+            if (i == size()) {
+                if consteval {
+                    throw std::out_of_range("FrozenBiMap::at: not found");
+                } else {
+        #ifndef NDEBUG
+                    log_err("FrozenBiMap::at: {} not found: {}", Side == EBiMapSide::Left ? "Key" : "Value", printable(kv));
+                    return s_Fallback<side_t<other(Side)>>; // fallback for a missing key/value
+        #else
+                    throw std::out_of_range(Side == EBiMapSide::Left ? "FrozenBiMap::at: key not found" : "FrozenBiMap::at: value not found");
+        #endif
+                }
+            }
+            if constexpr (Side == EBiMapSide::Left) return m_Entries[i].second;
+            else                                    return m_Entries[i].first;
+        }
+
+        template <EBiMapSide Side, typename KV>
+        constexpr bool contains_on(const KV& kv) const {
+            return find<Side>(lookup_key<side_t<Side>>(kv)) != size();
+        }
+
+        template <typename T>
+        static inline const T s_Fallback{};
+
+    private:
+        storage_t<value_type> m_Entries{};
+        storage_t<u32>        m_ByValue{};
+    };
+
+    /**
+    * @brief Fixed-size FrozenBiMap from a braced list, usable in constant expressions:
+    *        constexpr auto names = make_frozen_bimap<ELevel, std::string_view>({ { ELevel::INFO, "INFO" }, ... });
+    */
+    template <typename K, typename V, std::size_t N>
+    constexpr auto make_frozen_bimap(const std::pair<K, V> (&pairs)[N]) -> FrozenBiMap<K, V, N> {
+        return FrozenBiMap<K, V, N>(pairs);
+    }
+
+    /**
+    * @brief Bulk build from any range of pair-likes, duplicates on either side are found in one
+    *        pass over the sorted arrays instead of two probes per insert.
+    */
+    template <typename K, typename V, std::ranges::input_range R>
+    auto freeze(R&& pairs) -> FrozenBiMap<K, V> {
+        return FrozenBiMap<K, V>(std::forward<R>(pairs));
+    }
+
+    template <typename K, typename V, typename Policy, typename Alloc>
+    auto freeze(const BiMap<K, V, Policy, Alloc>& map) -> FrozenBiMap<K, V> {
+        return FrozenBiMap<K, V>(map);
+    }
+}
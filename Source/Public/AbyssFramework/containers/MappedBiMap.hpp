@@ -0,0 +1,346 @@
+#pragma once
+#include "BiMap.hpp"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace aby::containers {
+
+    /**
+    * @brief On-disk BiMap snapshot, written by MappedBiMap::save() and queried in place through mmap.
+    *
+    *        Layout: a bimapfile::Header, then count entries of `stride` bytes sorted by key
+    *        ([key cell][value cell]), then count u32 entry indices sorted by value, then the string pool.
+    *        A cell is the raw bytes of a trivially copyable type or, for std::string/std::string_view,
+    *        a StringCell (offset and length into the pool). All positions are file offsets, so the
+    *        file can be mapped anywhere and by several processes at once. Native byte order.
+    */
+    namespace bimapfile {
+        inline constexpr char magic[8] = { 'A', 'B', 'Y', 'B', 'I', 'M', 'A', 'P' };
+        inline constexpr u32  version  = 1;
+
+        enum EFlags : u32 {
+            KEY_STRING   = 1 << 0,
+            VALUE_STRING = 1 << 1,
+        };
+
+        struct Header {
+            char magic[8];
+            u32  version;
+            u32  header_size;
+            u32  key_size;   // Bytes per key cell.
+            u32  value_size; // Bytes per value cell.
+            u32  flags;      // EFlags.
+            u32  stride;     // Bytes per entry.
+            u64  count;
+            u64  entries;    // File offsets of the three sections.
+            u64  by_value;
+            u64  pool;
+            u64  pool_size;
+            u64  checksum;   // checksum() of everything after the header.
+        };
+        static_assert(sizeof(Header) == 80);
+
+        struct StringCell {
+            u32 offset;
+            u32 size;
+        };
+
+        // FNV-1a over 8 byte words, catches truncated or damaged files, not tampering.
+        inline auto checksum(const std::byte* data, std::size_t size) -> u64 {
+            u64 hash = 0xcbf29ce484222325ULL;
+            std::size_t i = 0;
+            for (; i + sizeof(u64) <= size; i += sizeof(u64)) {
+                u64 word;
+                std::memcpy(&word, data + i, sizeof(word));
+                hash = (hash ^ word) * 0x100000001b3ULL;
+            }
+            for (; i < size; ++i) {
+                hash = (hash ^ static_cast<u8>(data[i])) * 0x100000001b3ULL;
+            }
+            return hash;
+        }
+    }
+
+    // Sides MappedBiMap can store: strings through the pool, or plain bytes (pointers would be meaningless).
+    template <typename T>
+    concept CMappable = CStringKey<T> || (std::is_trivially_copyable_v<T> && !std::is_pointer_v<T>);
+
+    /**
+    * @brief Read-only BiMap over a memory-mapped snapshot file: open() validates the header (and
+    *        by default the checksum) and every lookup is a binary search in the mapped pages, no
+    *        deserialization and no private heap copy. String sides come back as std::string_views
+    *        into the mapping, valid until close().
+    *        Same lookup rules as BiMap, at() has the same missing-entry behaviour but returns by value.
+    */
+    template <typename K, typename V> requires(CBiMap<K, V> && CMappable<K> && CMappable<V>)
+    class MappedBiMap {
+        template <typename T>
+        using cell_t = std::conditional_t<CStringKey<T>, std::string_view, T>;
+    public:
+        using key_type    = K;
+        using mapped_type = V;
+        using size_type   = std::size_t;
+
+        /**
+        * @brief  Write pairs (any range of pair-likes: a BiMap, a FrozenBiMap, a vector of pairs) to path.
+        *         Goes through path + ".tmp" and a rename, processes that mapped the old file keep it.
+        * @return False on duplicates on either side or if the file can't be written.
+        */
+        template <std::ranges::input_range R>
+        static bool save(const fs::path& path, R&& pairs) {
+            std::vector<std::pair<K, V>> sorted;
+            for (const auto& [k, v] : pairs)
+                sorted.emplace_back(k, v);
+            if (sorted.size() >= std::numeric_limits<u32>::max())
+                return false;
+
+            std::ranges::sort(sorted, std::less<>{}, &std::pair<K, V>::first);
+            std::vector<u32> by_value(sorted.size());
+            std::iota(by_value.begin(), by_value.end(), 0u);
+            std::ranges::sort(by_value, std::less<>{}, [&](u32 i) -> const V& { return sorted[i].second; });
+            for (size_type i = 1; i < sorted.size(); ++i) {
+                if (!(sorted[i - 1].first < sorted[i].first) || !(sorted[by_value[i - 1]].second < sorted[by_value[i]].second))
+                    return false;
+            }
+
+            bimapfile::Header header{};
+            std::memcpy(header.magic, bimapfile::magic, sizeof(bimapfile::magic));
+            header.version     = bimapfile::version;
+            header.header_size = sizeof(bimapfile::Header);
+            header.key_size    = cell_size<K>();
+            header.value_size  = cell_size<V>();
+            header.flags       = flags();
+            header.stride      = stride();
+            header.count       = sorted.size();
+            header.entries     = align_up(sizeof(bimapfile::Header), 16);
+            header.by_value    = header.entries + header.count * header.stride;
+            header.pool        = header.by_value + header.count * sizeof(u32);
+            for (const auto& [k, v] : sorted)
+                header.pool_size += pool_bytes(k) + pool_bytes(v);
+            if (header.pool_size > std::numeric_limits<u32>::max())
+                return false;
+
+            fs::path tmp = path;
+            tmp += ".tmp";
+            {
+                MappedFile file;
+                if (!file.open(tmp, MappedFile::EMode::READ_WRITE, header.pool + header.pool_size))
+                    return false;
+                std::byte* base = file.data();
+                std::memset(base, 0, static_cast<std::size_t>(header.pool));
+                u32 pool = 0;
+                for (size_type i = 0; i < sorted.size(); ++i) {
+                    std::byte* entry = base + header.entries + i * header.stride;
+                    put_cell(entry, base + header.pool, pool, sorted[i].first);
+                    put_cell(entry + value_offset(), base + header.pool, pool, sorted[i].second);
+                }
+                if (!by_value.empty())
+                    std::memcpy(base + header.by_value, by_value.data(), by_value.size() * sizeof(u32));
+                header.checksum = bimapfile::checksum(base + sizeof(header), file.size() - sizeof(header));
+                std::memcpy(base, &header, sizeof(header));
+                if (!file.sync())
+                    return false;
+            }
+            std::error_code ec;
+            fs::rename(tmp, path, ec);
+            return !ec;
+        }
+
+        /**
+        * @brief  Map a file written by save() for the same K and V.
+        * @return False if it's missing, was written for other types or is damaged. verify = false
+        *         skips the checksum, which otherwise reads every page once.
+        */
+        bool open(const fs::path& path, bool verify = true) {
+            close();
+            if (!m_File.open(path, MappedFile::EMode::READ) || m_File.size() < sizeof(bimapfile::Header)) {
+                m_File.close();
+                return false;
+            }
+            bimapfile::Header header;
+            std::memcpy(&header, m_File.data(), sizeof(header));
+            u64 file_size = m_File.size();
+            // Each region is bounded by the file before its end is computed, and count is compared
+            // by division, so a crafted header can't wrap the offsets around.
+            bool valid = std::memcmp(header.magic, bimapfile::magic, sizeof(bimapfile::magic)) == 0 &&
+                         header.version == bimapfile::version &&
+                         header.header_size == sizeof(bimapfile::Header) &&
+                         header.key_size == cell_size<K>() && header.value_size == cell_size<V>() &&
+                         header.flags == flags() && header.stride == stride() &&
+                         header.count < std::numeric_limits<u32>::max() &&
+                         header.entries >= sizeof(bimapfile::Header) && header.entries <= file_size &&
+                         header.count <= (file_size - header.entries) / header.stride &&
+                         header.by_value >= header.entries + header.count * header.stride && header.by_value <= file_size &&
+                         header.count <= (file_size - header.by_value) / sizeof(u32) &&
+                         header.pool >= header.by_value + header.count * sizeof(u32) &&
+                         header.pool_size <= file_size && header.pool <= file_size - header.pool_size;
+            if (!valid || (verify && header.checksum != bimapfile::checksum(m_File.data() + sizeof(header), m_File.size() - sizeof(header)))) {
+                m_File.close();
+                return false;
+            }
+            m_Count    = static_cast<size_type>(header.count);
+            m_Entries  = m_File.data() + header.entries;
+            m_ByValue  = m_File.data() + header.by_value;
+            m_Pool     = reinterpret_cast<const char*>(m_File.data() + header.pool);
+            m_PoolSize = header.pool_size;
+            return true;
+        }
+
+        void close() {
+            m_File.close();
+            m_Count = 0;
+        }
+
+        bool is_open() const { return m_File.is_open(); }
+
+        template <typename KV>
+        auto at(const KV& kv) const {
+            constexpr EBiMapSide side = lookup_side<KV, K, V>();
+            using result_t = cell_t<std::conditional_t<side == EBiMapSide::Left, V, K>>;
+            size_type i = find_on<side>(kv);
+            if (i == m_Count) {
+        #ifndef NDEBUG
+                log_err("MappedBiMap::at: {} not found: {}", side == EBiMapSide::Left ? "Key" : "Value", printable(kv));
+                return result_t{}; // fallback for a missing key/value
+        #else
+                throw std::out_of_range(side == EBiMapSide::Left ? "MappedBiMap::at: key not found" : "MappedBiMap::at: value not found");
+        #endif
+            }
+            if constexpr (side == EBiMapSide::Left) return value_at(i);
+            else                                    return key_at(i);
+        }
+
+        // at() without the missing-entry handling: empty if kv isn't there.
+        template <typename KV>
+        auto find(const KV& kv) const {
+            constexpr EBiMapSide side = lookup_side<KV, K, V>();
+            using result_t = cell_t<std::conditional_t<side == EBiMapSide::Left, V, K>>;
+            size_type i = find_on<side>(kv);
+            if (i == m_Count)
+                return std::optional<result_t>();
+            if constexpr (side == EBiMapSide::Left) return std::optional<result_t>(value_at(i));
+            else                                    return std::optional<result_t>(key_at(i));
+        }
+
+        template <typename KV>
+        bool contains(const KV& kv) const {
+            return find_on<lookup_side<KV, K, V>()>(kv) != m_Count;
+        }
+
+        // Pair i in key order, i < size().
+        auto entry(size_type i) const -> std::pair<cell_t<K>, cell_t<V>> {
+            return { key_at(i), value_at(i) };
+        }
+
+        size_type size() const { return m_Count; }
+        bool empty() const { return m_Count == 0; }
+
+    private:
+        template <typename T>
+        static constexpr auto cell_size() -> u32 {
+            return CStringKey<T> ? sizeof(bimapfile::StringCell) : sizeof(T);
+        }
+
+        template <typename T>
+        static constexpr auto cell_align() -> u32 {
+            return CStringKey<T> ? alignof(bimapfile::StringCell) : alignof(T);
+        }
+
+        static constexpr auto align_up(u64 value, u64 alignment) -> u64 {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        static constexpr auto flags() -> u32 {
+            return (CStringKey<K> ? bimapfile::KEY_STRING : 0u) | (CStringKey<V> ? bimapfile::VALUE_STRING : 0u);
+        }
+
+        static constexpr auto value_offset() -> u32 {
+            return static_cast<u32>(align_up(cell_size<K>(), cell_align<V>()));
+        }
+
+        // Entries stay aligned for both cells and for the u32 index that follows them.
+        static constexpr auto stride() -> u32 {
+            return static_cast<u32>(align_up(value_offset() + cell_size<V>(), std::max({ cell_align<K>(), cell_align<V>(), u32(alignof(u32)) })));
+        }
+
+        template <typename T>
+        static auto pool_bytes(const T& value) -> u64 {
+            if constexpr (CStringKey<T>) return std::string_view(value).size();
+            else                         return 0;
+        }
+
+        template <typename T>
+        static void put_cell(std::byte* dst, std::byte* pool, u32& pool_used, const T& value) {
+            if constexpr (CStringKey<T>) {
+                std::string_view str(value);
+                bimapfile::StringCell cell{ pool_used, static_cast<u32>(str.size()) };
+                if (!str.empty())
+                    std::memcpy(pool + pool_used, str.data(), str.size());
+                pool_used += cell.size;
+                std::memcpy(dst, &cell, sizeof(cell));
+            } else {
+                std::memcpy(dst, &value, sizeof(T));
+            }
+        }
+
+        template <typename T>
+        auto get_cell(const std::byte* src) const -> cell_t<T> {
+            if constexpr (CStringKey<T>) {
+                bimapfile::StringCell cell;
+                std::memcpy(&cell, src, sizeof(cell));
+                if (static_cast<u64>(cell.offset) + cell.size > m_PoolSize)
+                    return {}; // Only reachable with verify = false on a damaged file.
+                return std::string_view(m_Pool + cell.offset, cell.size);
+            } else {
+                T value;
+                std::memcpy(&value, src, sizeof(T));
+                return value;
+            }
+        }
+
+        auto key_at(size_type i) const -> cell_t<K> { return get_cell<K>(m_Entries + i * stride()); }
+        auto value_at(size_type i) const -> cell_t<V> { return get_cell<V>(m_Entries + i * stride() + value_offset()); }
+
+        auto value_index(size_type i) const -> size_type {
+            u32 index;
+            std::memcpy(&index, m_ByValue + i * sizeof(u32), sizeof(index));
+            return std::min<size_type>(index, m_Count - 1);
+        }
+
+        // Entry holding kv on Side, or size() if there is none.
+        template <EBiMapSide Side, typename KV>
+        auto find_on(const KV& kv) const -> size_type {
+            using side_t = std::conditional_t<Side == EBiMapSide::Left, K, V>;
+            const auto& key = lookup_key<side_t>(kv);
+            auto at_rank = [&](size_type rank) {
+                if constexpr (Side == EBiMapSide::Left) return key_at(rank);
+                else                                    return value_at(value_index(rank));
+            };
+            size_type lo = 0, hi = m_Count;
+            while (lo < hi) {
+                size_type mid = lo + (hi - lo) / 2;
+                if (std::less<>{}(at_rank(mid), key)) lo = mid + 1;
+                else                                  hi = mid;
+            }
+            if (lo == m_Count || std::less<>{}(key, at_rank(lo)))
+                return m_Count;
+            return Side == EBiMapSide::Left ? lo : value_index(lo);
+        }
+
+    private:
+        MappedFile       m_File;
+        size_type        m_Count    = 0;
+        const std::byte* m_Entries  = nullptr;
+        const std::byte* m_ByValue  = nullptr;
+        const char*      m_Pool     = nullptr;
+        u64              m_PoolSize = 0;
+    };
+}
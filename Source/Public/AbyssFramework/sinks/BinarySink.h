@@ -0,0 +1,93 @@
+#pragma once
+
+#include "sinks/Sink.h"
+#include "sinks/FileSink.h"
+#include <fstream>
+#include <unordered_map>
+
+namespace aby::log {
+
+    /**
+    * @brief Compact binary log, decoded offline by AbyssFrameworkLogDecode.
+    *
+    *        The file is a stream of entries, each starting with an EBinaryEntry byte (little endian fields,
+    *        ArgBuffer payloads included, see convert_args_byte_order):
+    *          HEADER: "ABYLOG" u16 version, u64 ticks per second.       Written each time a sink opens the file.
+    *          SITE:   u32 id, u8 level, u32 line, u16 len + file, u32 len + format string.
+    *                  Written once per file (after the header), the first time a call site logs.
+    *          LOG:    u32 site id, i64 ticks, u8 level, u8 arg count, u16 len + ArgBuffer bytes.
+    *          TEXT:   i64 ticks, u8 level, u32 len + text.               Messages formatted on the caller.
+    *        Site ids restart after every HEADER, so appending a new session to an old file is fine.
+    */
+    namespace binlog {
+        inline constexpr char magic[6] = { 'A', 'B', 'Y', 'L', 'O', 'G' };
+        inline constexpr u16  version  = 1;
+
+        enum class EEntry : u8 {
+            HEADER = 0xAB,
+            SITE   = 1,
+            LOG    = 2,
+            TEXT   = 3,
+        };
+
+        struct Entry {
+            ELevel                                level = ELevel::NONE;
+            std::chrono::system_clock::time_point time;
+            std::string                           file; // Empty for TEXT entries.
+            int                                   line = 0;
+            std::string                           text; // Rendered message.
+        };
+
+        /**
+        * @brief Streams decoded messages out of a binary log file.
+        */
+        class Reader {
+        public:
+            explicit Reader(const fs::path& path);
+
+            bool is_open() const;
+            // False at end of file or on a malformed entry, see corrupt().
+            bool next(Entry& out);
+            bool corrupt() const;
+        private:
+            template <typename T>
+            bool read(T& value);
+            bool read_string(std::string& out, std::size_t len);
+        private:
+            struct Site {
+                ELevel      level = ELevel::NONE;
+                int         line  = 0;
+                std::string file;
+                std::string fmt;
+            };
+
+            std::ifstream                      m_File;
+            std::unordered_map<u32, Site>      m_Sites;
+            i64                                m_TicksPerSecond;
+            bool                               bCorrupt;
+            std::string                        m_Args;
+        };
+    }
+
+    class BinarySink : public ISink {
+    public:
+        BinarySink(const fs::path& path, std::size_t buffer_size = 256 * 1024, const FlushPolicy& policy = {});
+
+        void write(const Record& record, std::string_view line) override;
+        void flush() override;
+        void flush_if_due(std::chrono::steady_clock::time_point now) override;
+        auto io_stats() const -> IoStats override;
+    private:
+        void put_header();
+        auto site_id(const CallSite& site) -> u32;
+
+        template <typename T>
+        void put(const T& value);
+        void put_bytes(const void* data, std::size_t size);
+    private:
+        FileSink                                 m_File;
+        std::unordered_map<const CallSite*, u32> m_Sites;
+        std::string                              m_Entry; // Scratch for the entry being encoded.
+    };
+
+}
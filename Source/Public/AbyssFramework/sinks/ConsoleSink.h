@@ -0,0 +1,55 @@
+#pragma once
+
+#include "sinks/Sink.h"
+#include <vector>
+
+namespace aby::log {
+
+    /**
+    * @brief Console output written straight to file descriptors 1 and 2, with its own buffers instead of stdio's.
+    *        Levels at or above stderr_level go to stderr, the rest to stdout. stdout is flushed before
+    *        anything goes to stderr, so a terminal showing both keeps the order.
+    *        On a terminal every batch of lines is written out right away (like stdio's line buffering).
+    *        Redirected output is buffered per FlushPolicy, Logger::flush() writes it out.
+    *        The logger's console is Config::console, formatted with the colored TextFormatter unless it has its own.
+    */
+    class ConsoleSink : public ISink {
+    public:
+        explicit ConsoleSink(ELevel stderr_level = ELevel::ERROR, std::size_t buffer_size = 16 * 1024, const FlushPolicy& policy = {});
+        ~ConsoleSink() override;
+
+        ConsoleSink(const ConsoleSink&) = delete;
+        ConsoleSink& operator=(const ConsoleSink&) = delete;
+
+        bool needs_text() const override { return true; }
+        void write(const Record& record, std::string_view line) override;
+        void flush() override;
+        void flush_if_due(std::chrono::steady_clock::time_point now) override;
+        auto io_stats() const -> IoStats override;
+
+        // Buffer lines (all of level) for the stream level goes to. Terminals get them at the next end_batch().
+        void append(ELevel level, std::string_view lines);
+        // Write out what a terminal should see now, write() is append() + end_batch().
+        void end_batch();
+
+        auto stderr_level() const -> ELevel;
+    private:
+        struct Stream {
+            int                                   fd;
+            bool                                  bTerminal;
+            std::vector<char>                     buffer;
+            std::chrono::steady_clock::time_point oldest;
+        };
+
+        auto stream_for(ELevel level) -> Stream&;
+        void flush(Stream& stream);
+        void write_all(Stream& stream, std::string_view data);
+    private:
+        ELevel      m_StderrLevel;
+        FlushPolicy m_Policy;
+        Stream      m_Out;
+        Stream      m_Err;
+        IoStats     m_Stats;
+    };
+
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Log.h"
+#include <string_view>
+#include <span>
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <condition_variable>
+
+namespace aby::log {
+
+    /**
+    * @brief Log file that is opened once in append mode and collects messages in a
+    *        user-space buffer, so a message costs a memcpy instead of an open/write/close.
+    *        With a RotationPolicy the file is renamed to "<stem>.<YYYYMMDD-HHMMSS><ext>" once it
+    *        is due and a fresh one is opened in its place, on_rotate is told the closed segment.
+    *        Not thread safe, the logger serializes access.
+    */
+    class FileSink {
+    public:
+        using RotateFn = std::function<void(const fs::path& segment)>;
+
+        FileSink(const fs::path& path, std::size_t buffer_size, const FlushPolicy& policy, const RotationPolicy& rotation = {}, RotateFn on_rotate = {});
+        ~FileSink();
+
+        FileSink(const FileSink&) = delete;
+        FileSink& operator=(const FileSink&) = delete;
+
+        void write(ELevel level, std::string_view formatted_msg);
+        /**
+        * @brief Write several already formatted lines at once, level is the most urgent among them.
+        *        Buffered like write() while they fit, otherwise the pending buffer and the blocks
+        *        go out in one vectored write (writev) without being copied.
+        */
+        void write_batch(std::span<const std::string_view> blocks, ELevel level);
+        void flush();
+        void flush_if_due(std::chrono::steady_clock::time_point now);
+
+        bool is_open() const;
+        auto path() const -> const fs::path&;
+        // Bytes handed to the OS and failed writes, including those dropped while the file couldn't be opened.
+        auto stats() const -> const IoStats&;
+    private:
+        void open();
+        bool rotation_due(std::size_t incoming) const;
+        void rotate();
+        auto next_segment_path() -> fs::path;
+        void write_through(std::string_view data);
+        void skip(std::size_t bytes);
+        void write_vectored(std::span<const std::string_view> blocks);
+    private:
+        fs::path                              m_Path;
+        std::FILE*                            m_File;
+        std::vector<char>                     m_Buffer;
+        FlushPolicy                           m_Policy;
+        std::chrono::steady_clock::time_point m_OldestPending;
+        RotationPolicy                        m_Rotation;
+        RotateFn                              m_OnRotate;
+        u64                                   m_SegmentSize;  // Bytes in the current segment, buffered ones included.
+        std::chrono::system_clock::time_point m_NextRotation; // Next interval boundary.
+        std::string                           m_LastStamp;    // Time stamp of the last segment name.
+        u32                                   m_StampSeq;
+        IoStats                               m_Stats;
+    };
+
+    /**
+    * @brief Background worker that compresses closed log segments and enforces the keep-N
+    *        retention, so neither ever runs on a thread that is writing log records.
+    *        One worker serves every logger (see shared()), each job reports through its own on_event
+    *        (ROTATED is not used here) from the worker thread.
+    */
+    class SegmentArchiver {
+    public:
+        using EventFn = std::function<void(EMessageType type, const fs::path& file)>;
+
+        SegmentArchiver() = default;
+        ~SegmentArchiver();
+
+        SegmentArchiver(const SegmentArchiver&) = delete;
+        SegmentArchiver& operator=(const SegmentArchiver&) = delete;
+
+        // Queue a closed segment of active, owner tags the job for wait(). Starts the worker thread on first use.
+        void submit(const void* owner, const fs::path& active, const fs::path& segment, const RotationPolicy& rotation, EventFn on_event);
+        // Block until no job of owner is queued or running, after which its on_event is never called again.
+        void wait(const void* owner);
+        // Finish the queued jobs and join the worker.
+        void stop();
+
+        // The process-wide archiver, created when the first logger asks for it and gone with the last one.
+        static auto shared() -> Ref<SegmentArchiver>;
+    private:
+        struct Job {
+            const void*    owner;
+            fs::path       active;
+            fs::path       segment;
+            RotationPolicy rotation;
+            EventFn        on_event;
+        };
+
+        void run();
+        void process(const Job& job);
+        void enforce_retention(const Job& job);
+        bool has_jobs_of(const void* owner) const;
+    private:
+        std::mutex              m_Mutex;
+        std::condition_variable m_Wake;
+        std::condition_variable m_Done;    // A job finished.
+        std::deque<Job>         m_Jobs;
+        const void*             m_Running = nullptr; // Owner of the job being processed.
+        std::thread             m_Worker;
+        bool                    m_bStopping = false;
+    };
+
+}
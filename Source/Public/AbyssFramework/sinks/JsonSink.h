@@ -0,0 +1,40 @@
+#pragma once
+
+#include "sinks/Sink.h"
+#include "sinks/FileSink.h"
+
+namespace aby::log {
+
+    /**
+    * @brief JSON lines: one object per record, for log shippers and jq.
+    *          {"ts":"2026-10-15T13:37:00.042133Z","level":"WARN","msg":"...","file":"Net.cpp","line":42,"fields":{"user":"bob","id":7}}
+    *        ts is UTC, level uses the fixed ELevel names (not Config::level_names), file/line are
+    *        present for log_* call sites. The record's fields go in their own "fields" object, so their
+    *        keys never collide with the ones above, followed by "fields_dropped" if some didn't fit the record.
+    *        Deferred records are rendered here, and everything is serialized straight into a
+    *        buffer that is reused, so a record costs no allocation once the buffers have grown.
+    */
+    class JsonSink : public ISink {
+    public:
+        JsonSink(const fs::path& path, std::size_t buffer_size = 64 * 1024, const FlushPolicy& policy = {});
+
+        void write(const Record& record, std::string_view line) override;
+        void flush() override;
+        void flush_if_due(std::chrono::steady_clock::time_point now) override;
+        auto io_stats() const -> IoStats override;
+
+        // The object for record, without the trailing newline. The view stays valid until the next call.
+        auto serialize(const Record& record) -> std::string_view;
+    private:
+        void put_time(std::chrono::system_clock::time_point time);
+        void put_string(std::string_view str);
+        void put_value(const FieldValue& value);
+    private:
+        FileSink    m_File;
+        std::string m_Line; // Object being serialized.
+        std::string m_Text; // Scratch for rendering deferred records.
+        i64         m_CachedSecond = -1;
+        char        m_CachedPrefix[20]; // "YYYY-MM-DDTHH:MM:SS." of m_CachedSecond.
+    };
+
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "sinks/Sink.h"
+#include "MappedFile.h"
+
+namespace aby::log {
+
+    /**
+    * @brief Flight recorder: keeps the most recent log lines in a memory-mapped file used as a ring.
+    *        Writing is a memcpy into the mapping, no syscalls. The pages belong to the OS page cache,
+    *        so whatever was written survives the process crashing. flush() (and therefore
+    *        Logger::flush / Logger::assertion) additionally syncs them to disk.
+    *        Read back with ringlog::Reader or the AbyssFrameworkRingDump tool.
+    *
+    *        Layout: a 64 byte ringlog::Header followed by `capacity` data bytes holding
+    *        [u32 length][line bytes] records that may wrap around the end.
+    */
+    namespace ringlog {
+        inline constexpr char magic[8] = { 'A', 'B', 'Y', 'R', 'I', 'N', 'G', '\0' };
+        inline constexpr u32  version  = 1;
+
+        struct Header {
+            char magic[8];
+            u32  version;
+            u32  header_size;
+            u64  capacity;    // Data bytes after the header.
+            u64  head;        // Total bytes ever written, the next record starts at head % capacity.
+            u64  tail;        // Start of the oldest complete record, same numbering as head.
+            u64  reserved[3];
+        };
+        static_assert(sizeof(Header) == 64);
+
+        /**
+        * @brief Reads the records of a ring file, oldest first.
+        */
+        class Reader {
+        public:
+            explicit Reader(const fs::path& path);
+
+            // False if the file is missing or isn't a ring log.
+            bool is_open() const;
+            // False after the newest record, or if a record is malformed (see corrupt()).
+            bool next(std::string& line);
+            bool corrupt() const;
+        private:
+            MappedFile m_File;
+            u64        m_Capacity;
+            u64        m_Pos;
+            u64        m_End;
+            bool       bCorrupt;
+        };
+    }
+
+    class RingSink : public ISink {
+    public:
+        // Reuses the existing contents of path if it is a ring of the same capacity.
+        // A capacity of sizeof(u32) or less leaves the sink closed, see is_open().
+        RingSink(const fs::path& path, std::size_t capacity = 4 * 1024 * 1024);
+
+        bool needs_text() const override { return true; }
+        void write(const Record& record, std::string_view line) override;
+        void flush() override;
+
+        bool is_open() const;
+    private:
+        void copy_in(u64 pos, const void* src, std::size_t size);
+        auto length_at(u64 pos) const -> u32;
+    private:
+        MappedFile       m_File;
+        ringlog::Header* m_Header;
+        std::byte*       m_Data;
+        u64              m_Capacity;
+    };
+
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Log.h"
+
+namespace aby::log {
+
+    /**
+    * @brief What a formatter gets to build a line from.
+    */
+    struct FormatContext {
+        const Config&    config;
+        const Record&    record;
+        std::string_view timestamp; // record.time in Config::time_precision.
+        std::string_view text;      // The message, already rendered for deferred records.
+        std::string_view logger;    // Logger::name() of the logger writing the record.
+    };
+
+    /**
+    * @brief Turns a record into the line a text output writes.
+    *        The logger formats each record at most once per formatter instance, only if an output that
+    *        takes the record's level uses it, so outputs sharing one formatter share its line.
+    *        Called with the logger's mutex held.
+    */
+    class IFormatter {
+    public:
+        virtual ~IFormatter() = default;
+
+        // Append the line for ctx to out, including the trailing newline.
+        virtual void format(std::string& out, const FormatContext& ctx) const = 0;
+    };
+
+    /**
+    * @brief The logger's own layout, "[timestamp] [LEVEL] text\n" (see format_line), optionally with Config::level_colors.
+    */
+    class TextFormatter : public IFormatter {
+    public:
+        explicit TextFormatter(bool color = false) : m_bColor(color) {}
+
+        void format(std::string& out, const FormatContext& ctx) const override;
+
+        // Shared instances, the defaults for files and sinks (plain) and for the console (colored).
+        static auto plain() -> const Ref<IFormatter>&;
+        static auto colored() -> const Ref<IFormatter>&;
+    private:
+        bool m_bColor;
+    };
+
+    /**
+    * @brief Output registered through Config::add_sink.
+    *        Called by the logger with its mutex held (on the backend thread in async mode),
+    *        so implementations don't need their own locking.
+    *        record.render is null for messages that were formatted on the caller (record.text is set then),
+    *        record.site is null for messages that didn't come from a log_* call site.
+    */
+    class ISink {
+    public:
+        virtual ~ISink() = default;
+
+        // Whether write() wants the formatted line. Deferred records are only rendered if some output does.
+        virtual bool needs_text() const { return false; }
+        // line is the formatted log line if needs_text(), empty otherwise.
+        virtual void write(const Record& record, std::string_view line) = 0;
+        virtual void flush() {}
+        // Time-based flushing hook, called by the async backend while idle.
+        virtual void flush_if_due(std::chrono::steady_clock::time_point now) { (void)now; }
+        // What the sink handed to the OS, reported by Logger::metrics(). Empty for sinks that don't track it.
+        virtual auto io_stats() const -> IoStats { return {}; }
+
+        // Levels written to this sink, on top of Config::level. All by default.
+        ISink& set_levels(LevelMask levels) {
+            m_Levels = levels;
+            return *this;
+        }
+        // Levels up to level, the same cut-off as Config::level.
+        ISink& set_level(ELevel level) {
+            return set_levels(levels_up_to(level));
+        }
+        // Formatter of the line passed to write(), null for the plain TextFormatter.
+        ISink& set_formatter(Ref<IFormatter> formatter) {
+            m_Formatter = std::move(formatter);
+            return *this;
+        }
+
+        auto levels() const -> LevelMask { return m_Levels; }
+        bool accepts(ELevel level) const { return (m_Levels & level_bit(level)) != 0; }
+        auto formatter() const -> const Ref<IFormatter>& { return m_Formatter; }
+    private:
+        LevelMask       m_Levels = all_levels;
+        Ref<IFormatter> m_Formatter;
+    };
+
+}
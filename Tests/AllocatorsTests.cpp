@@ -0,0 +1,133 @@
+#include "Test.h"
+#include <AbyssFramework/Allocators.h>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <vector>
+
+namespace {
+
+    // Upstream that remembers every block it hands out, so tests can check allocations stay inside them.
+    class TrackingResource : public std::pmr::memory_resource {
+    public:
+        bool contains(const void* p, std::size_t bytes) const {
+            auto begin = reinterpret_cast<std::uintptr_t>(p);
+            for (const auto& block : m_Blocks) {
+                auto start = reinterpret_cast<std::uintptr_t>(block.first);
+                if (begin >= start && begin + bytes <= start + block.second) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        auto blocks() const -> std::size_t { return m_Blocks.size(); }
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            void* p = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+            m_Blocks.emplace_back(p, bytes);
+            return p;
+        }
+
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+            std::erase_if(m_Blocks, [p](const auto& block) { return block.first == p; });
+            std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    private:
+        std::vector<std::pair<void*, std::size_t>> m_Blocks;
+    };
+
+    bool aligned(const void* p, std::size_t alignment) {
+        return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+    }
+
+}
+
+ABY_TEST(Allocators, ArenaAlignsPastChunkEnd) {
+    // The cursor ends a few bytes short of an odd-sized chunk, aligning it used to step past the end.
+    TrackingResource upstream;
+    aby::Arena arena(256, &upstream);
+    void* first  = arena.allocate(1001, 1);
+    void* second = arena.allocate(8, 8);
+    ABY_CHECK(upstream.contains(first, 1001));
+    ABY_CHECK(upstream.contains(second, 8));
+    ABY_CHECK(aligned(second, 8));
+}
+
+ABY_TEST(Allocators, ArenaMixedAlignments) {
+    TrackingResource upstream;
+    aby::Arena arena(300, &upstream);
+    static constexpr std::size_t alignments[] = { 1, 2, 4, 8, 16, 32, 64, 128 };
+    struct Block { unsigned char* p; std::size_t size; unsigned char fill; };
+    std::vector<Block> blocks;
+    for (int round = 0; round < 2; ++round) {
+        blocks.clear();
+        for (std::size_t i = 0; i < 2000; ++i) {
+            std::size_t alignment = alignments[i % std::size(alignments)];
+            std::size_t size      = 1 + (i * 37) % 211;
+            auto* p = static_cast<unsigned char*>(arena.allocate(size, alignment));
+            ABY_CHECK(aligned(p, alignment));
+            ABY_CHECK(upstream.contains(p, size));
+            std::memset(p, static_cast<int>(i & 0xff), size);
+            blocks.push_back({ p, size, static_cast<unsigned char>(i & 0xff) });
+        }
+        // Nothing overlaps: every block still holds its own fill.
+        for (const auto& block : blocks) {
+            for (std::size_t i = 0; i < block.size; ++i) {
+                if (block.p[i] != block.fill) {
+                    ABY_CHECK(block.p[i] == block.fill);
+                    break;
+                }
+            }
+        }
+        // The second round reuses the chunks.
+        auto chunks = upstream.blocks();
+        arena.reset();
+        ABY_CHECK(arena.used() == 0);
+        ABY_CHECK(upstream.blocks() == chunks);
+    }
+    arena.release();
+    ABY_CHECK(upstream.blocks() == 0);
+}
+
+ABY_TEST(Allocators, NodePoolMixedAlignments) {
+    TrackingResource upstream;
+    aby::NodePool pool(48, 16, &upstream);
+    ABY_CHECK(pool.block_size() % alignof(std::max_align_t) == 0);
+
+    std::vector<std::pair<void*, std::size_t>> live;
+    for (std::size_t i = 0; i < 500; ++i) {
+        std::size_t alignment = std::size_t(1) << (i % 8); // Up to 128, past max_align_t goes upstream.
+        std::size_t size      = 1 + i % 64;                // Past block_size goes upstream too.
+        void* p = pool.allocate(size, alignment);
+        ABY_CHECK(aligned(p, alignment));
+        ABY_CHECK(upstream.contains(p, size));
+        live.emplace_back(p, size | (alignment << 16));
+        if (i % 3 == 0) {
+            // Free an older block, the next pooled request reuses it.
+            auto [q, packed] = live[live.size() / 2];
+            pool.deallocate(q, packed & 0xffff, packed >> 16);
+            live.erase(live.begin() + static_cast<std::ptrdiff_t>(live.size() / 2));
+        }
+    }
+    for (auto [p, packed] : live) {
+        pool.deallocate(p, packed & 0xffff, packed >> 16);
+    }
+    pool.release();
+    ABY_CHECK(upstream.blocks() == 0);
+}
+
+ABY_TEST(Allocators, PmrContainers) {
+    aby::Arena arena(1000);
+    aby::NodePool pool(64, 8);
+    std::pmr::vector<std::uint64_t> numbers(&arena);
+    std::pmr::list<std::uint64_t>   nodes(&pool);
+    for (std::uint64_t i = 0; i < 10000; ++i) {
+        numbers.push_back(i);
+        nodes.push_back(i);
+    }
+    ABY_CHECK(numbers.size() == 10000 && numbers.back() == 9999);
+    ABY_CHECK(nodes.size() == 10000 && nodes.back() == 9999);
+}
@@ -0,0 +1,76 @@
+#include "Test.h"
+#include <AbyssFramework/containers/BiMap.hpp>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+    using FlatMap = aby::containers::BiMap<std::uint64_t, std::string, aby::containers::FlatHashPolicy>;
+
+    auto value_for(std::uint64_t key) -> std::string {
+        return "v" + std::to_string(key);
+    }
+
+    // Every pair of the model is found from both sides, and nothing else is in the map.
+    bool matches(const FlatMap& map, const std::unordered_map<std::uint64_t, std::string>& model) {
+        if (map.size() != model.size()) {
+            return false;
+        }
+        for (const auto& [key, value] : model) {
+            if (!map.contains(key) || !map.contains(value) || map.at(key) != value || map.at(value) != key) {
+                return false;
+            }
+        }
+        for (const auto& [key, value] : map) {
+            if (!model.contains(key)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+ABY_TEST(BiMap, FlatHashEraseReinsert) {
+    // Few distinct keys and many erases, so probe chains keep getting shifted back over each other.
+    FlatMap map;
+    std::unordered_map<std::uint64_t, std::string> model;
+    std::mt19937_64 rng(7);
+    for (int step = 0; step < 20000; ++step) {
+        std::uint64_t key = rng() % 300;
+        if (rng() % 3 == 0) {
+            bool present = model.erase(key) != 0;
+            if (present) {
+                // Alternate the side the pair is erased from.
+                ABY_CHECK(step % 2 ? map.erase(key) : map.erase(value_for(key)));
+            }
+        } else {
+            ABY_CHECK(map.insert(key, value_for(key)) == model.emplace(key, value_for(key)).second);
+        }
+        if (step % 500 == 0) {
+            ABY_CHECK(matches(map, model));
+        }
+    }
+    ABY_CHECK(matches(map, model));
+
+    // Erase everything and put it all back: a table emptied by shifting must find every pair again.
+    for (const auto& [key, value] : model) {
+        ABY_CHECK(map.erase(key));
+    }
+    ABY_CHECK(map.empty());
+    for (const auto& [key, value] : model) {
+        ABY_CHECK(map.insert(key, value));
+    }
+    ABY_CHECK(matches(map, model));
+}
+
+ABY_TEST(BiMap, FlatHashRejectsDuplicateSides) {
+    FlatMap map;
+    ABY_CHECK(map.insert(1, "one"));
+    ABY_CHECK(!map.insert(1, "uno"));  // Key taken.
+    ABY_CHECK(!map.insert(2, "one"));  // Value taken.
+    ABY_CHECK(map.erase(std::string("one")));
+    ABY_CHECK(map.insert(2, "one"));
+    ABY_CHECK(map.at(2) == "one" && map.at(std::string("one")) == 2);
+}
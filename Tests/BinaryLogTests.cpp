@@ -0,0 +1,133 @@
+#include "Test.h"
+#include <AbyssFramework/Log.h>
+#include <AbyssFramework/Macros.h>
+#include <AbyssFramework/sinks/BinarySink.h>
+#include <chrono>
+#include <format>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using aby::log::ELevel;
+
+    struct Expected {
+        ELevel      level;
+        std::string text;
+    };
+
+    auto open_logger(aby::log::Logger& logger, const aby::fs::path& path) -> aby::log::Logger& {
+        logger.config().set_level(ELevel::ALL).set_to_console(false).set_async(false).add_sink(aby::create_ref<aby::log::BinarySink>(path));
+        return logger;
+    }
+
+    // Everything in path, decoded the way AbyssFrameworkLogDecode does it.
+    auto decode(const aby::fs::path& path, bool& corrupt) -> std::vector<aby::log::binlog::Entry> {
+        std::vector<aby::log::binlog::Entry> entries;
+        aby::log::binlog::Reader reader(path);
+        ABY_CHECK(reader.is_open());
+        aby::log::binlog::Entry entry;
+        while (reader.next(entry)) {
+            entries.push_back(entry);
+        }
+        corrupt = reader.corrupt();
+        return entries;
+    }
+
+    void check_entries(const std::vector<aby::log::binlog::Entry>& entries, const std::vector<Expected>& expected) {
+        ABY_CHECK(entries.size() == expected.size());
+        for (std::size_t i = 0; i < entries.size() && i < expected.size(); ++i) {
+            ABY_CHECK(entries[i].level == expected[i].level);
+            if (entries[i].text != expected[i].text) {
+                std::fprintf(stderr, "entry %zu: \"%s\", expected \"%s\"\n", i, entries[i].text.c_str(), expected[i].text.c_str());
+                ABY_CHECK(entries[i].text == expected[i].text);
+            }
+        }
+    }
+
+}
+
+ABY_TEST(BinaryLog, DeferredArgsRoundTrip) {
+    auto path  = aby::test::temp_path("args.abylog");
+    auto start = std::chrono::system_clock::now() - std::chrono::seconds(1);
+    std::vector<Expected> expected;
+    {
+        aby::log::Logger logger("binlog_args");
+        open_logger(logger, path);
+        std::string owned = "owned string";
+        for (int i = 0; i < 3; ++i) { // The repeats reuse the SITE entries.
+            log_info_to(logger, "ints {} {} {} {}", i, -7, 42u, std::uint64_t(1) << 40);
+            expected.push_back({ ELevel::INFO, std::format("ints {} {} {} {}", i, -7, 42u, std::uint64_t(1) << 40) });
+            log_warn_to(logger, "floats {} {:.3f} {}", 0.5f, 3.14159, -2.25);
+            expected.push_back({ ELevel::WARN, std::format("floats {} {:.3f} {}", 0.5f, 3.14159, -2.25) });
+            log_err_to(logger, "{} {} '{}' [{:>6}]", true, 'x', "literal", owned.substr(0, 5));
+            expected.push_back({ ELevel::ERROR, std::format("{} {} '{}' [{:>6}]", true, 'x', "literal", owned.substr(0, 5)) });
+            log_trace_to(logger, "{}", owned);
+            expected.push_back({ ELevel::TRACE, owned });
+        }
+        logger.flush();
+    }
+
+    bool corrupt = true;
+    auto entries = decode(path, corrupt);
+    ABY_CHECK(!corrupt);
+    check_entries(entries, expected);
+    for (const auto& entry : entries) {
+        ABY_CHECK(entry.file == "BinaryLogTests.cpp");
+        ABY_CHECK(entry.line > 0);
+        ABY_CHECK(entry.time >= start && entry.time <= std::chrono::system_clock::now());
+    }
+    // What the decoder prints: the same layout as the logger's text output.
+    std::string line;
+    aby::log::Config cfg;
+    aby::log::format_line(line, cfg, entries.front().level, "ts", entries.front().text, false);
+    ABY_CHECK(line.find(expected.front().text) != std::string::npos);
+    std::error_code ec;
+    aby::fs::remove(path, ec);
+}
+
+ABY_TEST(BinaryLog, TextAndAppendedSessions) {
+    auto path = aby::test::temp_path("sessions.abylog");
+    std::vector<Expected> expected;
+    for (int session = 0; session < 2; ++session) {
+        // The second logger appends a new HEADER, its site ids start over.
+        aby::log::Logger logger("binlog_session");
+        open_logger(logger, path);
+        log_info_to(logger, "session {} starts", session);
+        expected.push_back({ ELevel::INFO, std::format("session {} starts", session) });
+        logger.write(ELevel::WARN, std::format("formatted on the caller {}", session));
+        expected.push_back({ ELevel::WARN, std::format("formatted on the caller {}", session) });
+        log_err_to(logger, "session {} ends with {}", session, "an error");
+        expected.push_back({ ELevel::ERROR, std::format("session {} ends with {}", session, "an error") });
+        logger.flush();
+    }
+
+    bool corrupt = true;
+    check_entries(decode(path, corrupt), expected);
+    ABY_CHECK(!corrupt);
+    std::error_code ec;
+    aby::fs::remove(path, ec);
+}
+
+ABY_TEST(BinaryLog, TruncatedFileStopsCleanly) {
+    auto path = aby::test::temp_path("truncated.abylog");
+    {
+        aby::log::Logger logger("binlog_truncated");
+        open_logger(logger, path);
+        for (int i = 0; i < 10; ++i) {
+            log_info_to(logger, "message {} of {}", i, 10);
+        }
+        logger.flush();
+    }
+    aby::fs::resize_file(path, aby::fs::file_size(path) - 3);
+
+    bool corrupt = false;
+    auto entries = decode(path, corrupt);
+    ABY_CHECK(corrupt);
+    ABY_CHECK(entries.size() == 9);
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        ABY_CHECK(entries[i].text == std::format("message {} of {}", i, 10));
+    }
+    std::error_code ec;
+    aby::fs::remove(path, ec);
+}
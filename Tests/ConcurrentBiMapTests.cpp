@@ -0,0 +1,87 @@
+#include "Test.h"
+#include <AbyssFramework/containers/ConcurrentBiMap.hpp>
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using SharedMap = aby::containers::ConcurrentBiMap<std::uint64_t, std::string>;
+
+    constexpr std::uint64_t key_count = 256;
+
+    auto value_for(std::uint64_t key) -> std::string {
+        return "v" + std::to_string(key);
+    }
+
+}
+
+ABY_TEST(ConcurrentBiMap, ReadersSeeWholePairs) {
+    // One writer churns the table while readers check that every pair they see is complete and
+    // consistent from both sides. Checks run off the main thread, so errors are counted and checked after.
+    SharedMap map;
+    std::atomic<bool> done{ false };
+    std::atomic<std::uint64_t> errors{ 0 };
+    std::atomic<std::uint64_t> seen{ 0 };
+    std::atomic<std::uint64_t> reads{ 0 };
+
+    std::vector<std::thread> readers;
+    for (unsigned r = 0; r < 2; ++r) {
+        readers.emplace_back([&, r] {
+            std::mt19937_64 rng(r);
+            while (!done.load(std::memory_order_relaxed)) {
+                std::uint64_t key = rng() % key_count;
+                auto value = map.find(key);
+                if (value && *value != value_for(key)) {
+                    errors.fetch_add(1, std::memory_order_relaxed);
+                }
+                // Several lookups against one snapshot: the pair is there from both sides or not at all.
+                map.read([&](const SharedMap::map_type& snapshot) {
+                    bool left  = snapshot.contains(key);
+                    bool right = snapshot.contains(value_for(key));
+                    if (left != right || (left && snapshot.at(value_for(key)) != key)) {
+                        errors.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    std::uint64_t pairs = 0;
+                    for (const auto& [k, v] : snapshot) {
+                        pairs += v == value_for(k);
+                    }
+                    if (pairs != snapshot.size()) {
+                        errors.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    seen.fetch_add(left, std::memory_order_relaxed);
+                });
+                reads.fetch_add(1, std::memory_order_relaxed);
+                std::this_thread::yield(); // Leave the writer room on a single core.
+            }
+        });
+    }
+
+    std::mt19937_64 rng(99);
+    // Keep writing until the readers got their share too, the threads may start late on a busy machine.
+    for (int step = 0; step < 2000 || reads.load(std::memory_order_relaxed) < 2000; ++step) {
+        std::uint64_t key = rng() % key_count;
+        if (rng() % 2) {
+            map.insert(key, value_for(key));
+        } else if (map.contains(key)) {
+            ABY_CHECK(map.erase(key));
+        }
+    }
+    done.store(true, std::memory_order_relaxed);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    ABY_CHECK(errors.load() == 0);
+    ABY_CHECK(seen.load() > 0);
+    // Both copies ended up with the same edits: fill the rest and every key is there once.
+    for (std::uint64_t key = 0; key < key_count; ++key) {
+        map.insert(key, value_for(key));
+    }
+    ABY_CHECK(map.size() == key_count);
+    for (std::uint64_t key = 0; key < key_count; ++key) {
+        ABY_CHECK(map.at(value_for(key)) == key);
+    }
+}
@@ -0,0 +1,42 @@
+#include "Test.h"
+
+namespace aby::test {
+
+    namespace {
+        int s_Failures = 0;
+    }
+
+    auto cases() -> std::vector<Case>& {
+        static std::vector<Case> s_Cases;
+        return s_Cases;
+    }
+
+    void fail(const char* file, int line, const char* expr) {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+        ++s_Failures;
+    }
+
+}
+
+int main(int argc, char** argv) {
+    using namespace aby::test;
+
+    std::string_view suite = argc > 1 ? argv[1] : "";
+    int ran = 0;
+    for (const auto& test : cases()) {
+        if (!suite.empty() && test.suite != suite) {
+            continue;
+        }
+        int before = s_Failures;
+        test.run();
+        std::printf("%s %.*s.%.*s\n", s_Failures == before ? "[ OK ]" : "[FAIL]",
+                    static_cast<int>(test.suite.size()), test.suite.data(),
+                    static_cast<int>(test.name.size()), test.name.data());
+        ++ran;
+    }
+    if (ran == 0) {
+        std::fprintf(stderr, "no tests in suite %s\n", argv[1]);
+        return 1;
+    }
+    return s_Failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+#include "Test.h"
+#include <AbyssFramework/containers/BiMap.hpp>
+#include <AbyssFramework/containers/MappedBiMap.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    using NameMap   = aby::containers::MappedBiMap<std::uint64_t, std::string>;
+    using NumberMap = aby::containers::MappedBiMap<std::uint64_t, std::uint32_t>;
+
+    // Overwrites size bytes of path at offset, to damage a saved file.
+    void patch(const aby::fs::path& path, std::streamoff offset, const void* data, std::size_t size) {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(offset);
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    }
+
+}
+
+ABY_TEST(MappedBiMap, StringSideRoundTrip) {
+    auto path = aby::test::temp_path("names.abybimap");
+    aby::containers::BiMap<std::uint64_t, std::string> source;
+    for (std::uint64_t i = 0; i < 1000; ++i) {
+        // Scattered keys and values of different lengths, so neither side is saved in insertion order.
+        source.insert((i * 7919) % 1000, "name_" + std::to_string(i * 31) + std::string(i % 5, '!'));
+    }
+    ABY_CHECK(NameMap::save(path, source));
+
+    NameMap mapped;
+    ABY_CHECK(mapped.open(path));
+    ABY_CHECK(mapped.is_open());
+    ABY_CHECK(mapped.size() == source.size());
+    for (const auto& [key, value] : source) {
+        ABY_CHECK(mapped.contains(key));
+        ABY_CHECK(mapped.at(key) == value);
+        ABY_CHECK(mapped.at(std::string_view(value)) == key);
+        ABY_CHECK(mapped.find(value) == key);
+    }
+    for (std::size_t i = 1; i < mapped.size(); ++i) {
+        ABY_CHECK(mapped.entry(i - 1).first < mapped.entry(i).first);
+    }
+    ABY_CHECK(!mapped.find(std::uint64_t(1000)));
+    ABY_CHECK(!mapped.find(std::string("name_")));
+    ABY_CHECK(!mapped.contains(std::string("")));
+    mapped.close();
+    ABY_CHECK(!mapped.is_open() && mapped.empty());
+    std::error_code ec;
+    aby::fs::remove(path, ec);
+}
+
+ABY_TEST(MappedBiMap, IntegralSidesRoundTrip) {
+    auto path = aby::test::temp_path("numbers.abybimap");
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> pairs;
+    for (std::uint32_t i = 0; i < 500; ++i) {
+        pairs.emplace_back(std::uint64_t(i) << 33, 500 - i);
+    }
+    ABY_CHECK(NumberMap::save(path, pairs));
+
+    NumberMap mapped;
+    ABY_CHECK(mapped.open(path, false));
+    ABY_CHECK(mapped.size() == pairs.size());
+    for (const auto& [key, value] : pairs) {
+        ABY_CHECK(mapped.at(key) == value);
+        ABY_CHECK(mapped.at(value) == key);
+    }
+    ABY_CHECK(!mapped.find(std::uint32_t(0)));
+    ABY_CHECK(!mapped.find(std::uint64_t(1)));
+
+    // Saving again replaces the file, an empty map round trips too.
+    ABY_CHECK(NumberMap::save(path, std::vector<std::pair<std::uint64_t, std::uint32_t>>{}));
+    ABY_CHECK(mapped.open(path));
+    ABY_CHECK(mapped.empty());
+    ABY_CHECK(!mapped.contains(std::uint64_t(0)));
+    mapped.close();
+    std::error_code ec;
+    aby::fs::remove(path, ec);
+}
+
+ABY_TEST(MappedBiMap, SaveRejectsDuplicates) {
+    auto path = aby::test::temp_path("duplicates.abybimap");
+    std::vector<std::pair<std::uint64_t, std::string>> same_key   = { { 1, "a" }, { 2, "b" }, { 1, "c" } };
+    std::vector<std::pair<std::uint64_t, std::string>> same_value = { { 1, "a" }, { 2, "b" }, { 3, "a" } };
+    ABY_CHECK(!NameMap::save(path, same_key));
+    ABY_CHECK(!NameMap::save(path, same_value));
+    ABY_CHECK(!aby::fs::exists(path));
+}
+
+ABY_TEST(MappedBiMap, OpenRejectsBadFiles) {
+    auto path = aby::test::temp_path("damaged.abybimap");
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> pairs = { { 1, 10 }, { 2, 20 }, { 3, 30 } };
+    ABY_CHECK(NumberMap::save(path, pairs));
+
+    NameMap other_types;
+    ABY_CHECK(!other_types.open(path, false));
+
+    NumberMap mapped;
+    ABY_CHECK(!mapped.open(aby::test::temp_path("missing.abybimap")));
+
+    // A damaged entry fails the checksum, only verify = false takes it.
+    std::uint32_t damaged = 99;
+    patch(path, sizeof(aby::containers::bimapfile::Header) + sizeof(std::uint64_t), &damaged, sizeof(damaged));
+    ABY_CHECK(!mapped.open(path));
+    ABY_CHECK(mapped.open(path, false));
+
+    // Offsets that would wrap around past the end of the mapping are rejected without verify.
+    std::uint64_t entries = ~0ull - 7;
+    patch(path, offsetof(aby::containers::bimapfile::Header, entries), &entries, sizeof(entries));
+    ABY_CHECK(!mapped.open(path, false));
+    ABY_CHECK(!mapped.is_open());
+
+    std::uint64_t count = 1ull << 40;
+    ABY_CHECK(NumberMap::save(path, pairs));
+    patch(path, offsetof(aby::containers::bimapfile::Header, count), &count, sizeof(count));
+    ABY_CHECK(!mapped.open(path, false));
+    std::error_code ec;
+    aby::fs::remove(path, ec);
+}
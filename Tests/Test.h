@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Minimal self-registering test cases for the AbyssFrameworkTests target. Every suite is one CTest
+// test (see CMakeLists.txt), AbyssFrameworkTests <suite> runs only that suite.
+
+namespace aby::test {
+
+    struct Case {
+        std::string_view suite;
+        std::string_view name;
+        void           (*run)();
+    };
+
+    auto cases() -> std::vector<Case>&;
+    // Reports a failed check, the case keeps running.
+    void fail(const char* file, int line, const char* expr);
+
+    // A file in the temp directory for this test, removed first so a previous run doesn't leak into it.
+    inline auto temp_path(std::string_view name) -> std::filesystem::path {
+        auto path = std::filesystem::temp_directory_path() / ("aby_test_" + std::string(name));
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        return path;
+    }
+
+    struct Registrar {
+        Registrar(std::string_view suite, std::string_view name, void (*run)()) {
+            cases().push_back({ suite, name, run });
+        }
+    };
+
+}
+
+#define ABY_TEST(suite, name)                                                                       \
+    static void suite##_##name();                                                                   \
+    static ::aby::test::Registrar suite##_##name##_registrar(#suite, #name, &suite##_##name);      \
+    static void suite##_##name()
+
+#define ABY_CHECK(expr)                                        \
+    do {                                                       \
+        if (!(expr)) {                                         \
+            ::aby::test::fail(__FILE__, __LINE__, #expr);      \
+        }                                                      \
+    } while (0)
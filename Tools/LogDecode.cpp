@@ -0,0 +1,122 @@
+#include <AbyssFramework/Log.h>
+#include <AbyssFramework/sinks/BinarySink.h>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <optional>
+#include <sstream>
+
+// Turns a BinarySink file back into the text layout the logger writes to console/files.
+
+namespace {
+
+    void usage() {
+        std::fprintf(stderr,
+            "usage: AbyssFrameworkLogDecode <file> [options]\n"
+            "  --min-level <NAME>      skip levels below NAME (TRACE, INFO, WARN, DEBUG, ERROR, ASSERT)\n"
+            "  --max-level <NAME>      skip levels above NAME\n"
+            "  --from <Y-m-d H:M:S>    skip messages before this local time\n"
+            "  --to   <Y-m-d H:M:S>    skip messages after this local time\n"
+            "  --precision <s|ms|us>   timestamp precision (default s)\n"
+            "  --no-color              omit ANSI level colors\n");
+    }
+
+    auto parse_level(const aby::log::Config& cfg, std::string_view name) -> std::optional<aby::log::ELevel> {
+        for (const auto& [level, level_name] : cfg.level_names) {
+            if (level_name == name) {
+                return level;
+            }
+        }
+        return std::nullopt;
+    }
+
+    auto parse_time(const char* text) -> std::optional<std::chrono::system_clock::time_point> {
+        std::tm tm{};
+        std::istringstream is(text);
+        is >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
+        if (is.fail()) {
+            return std::nullopt;
+        }
+        tm.tm_isdst = -1;
+        return std::chrono::system_clock::from_time_t(std::mktime(&tm));
+    }
+
+}
+
+int main(int argc, char** argv) {
+    using namespace aby::log;
+
+    if (argc < 2) {
+        usage();
+        return 1;
+    }
+
+    Config cfg = Logger::get().config();
+    auto min_level = ELevel::NONE;
+    auto max_level = ELevel::ALL;
+    std::optional<std::chrono::system_clock::time_point> from, to;
+    auto precision = ETimePrecision::SECONDS;
+
+    for (int i = 2; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--no-color") {
+            cfg.level_colors.clear();
+        } else if ((arg == "--min-level" || arg == "--max-level") && has_value) {
+            auto level = parse_level(cfg, argv[++i]);
+            if (!level) {
+                std::fprintf(stderr, "unknown level: %s\n", argv[i]);
+                return 1;
+            }
+            (arg == "--min-level" ? min_level : max_level) = *level;
+        } else if ((arg == "--from" || arg == "--to") && has_value) {
+            auto time = parse_time(argv[++i]);
+            if (!time) {
+                std::fprintf(stderr, "bad time (want \"YYYY-MM-DD HH:MM:SS\"): %s\n", argv[i]);
+                return 1;
+            }
+            (arg == "--from" ? from : to) = time;
+        } else if (arg == "--precision" && has_value) {
+            std::string_view p = argv[++i];
+            if (p == "s") {
+                precision = ETimePrecision::SECONDS;
+            } else if (p == "ms") {
+                precision = ETimePrecision::MILLISECONDS;
+            } else if (p == "us") {
+                precision = ETimePrecision::MICROSECONDS;
+            } else {
+                std::fprintf(stderr, "unknown precision (want s, ms or us): %s\n", argv[i]);
+                return 1;
+            }
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    binlog::Reader reader(argv[1]);
+    if (!reader.is_open()) {
+        std::fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    TimestampCache timestamps(precision);
+    binlog::Entry  entry;
+    std::string    line;
+    while (reader.next(entry)) {
+        if (static_cast<int>(entry.level) < static_cast<int>(min_level) ||
+            static_cast<int>(entry.level) > static_cast<int>(max_level) ||
+            (from && entry.time < *from) || (to && entry.time > *to)) {
+            continue;
+        }
+        line.clear();
+        format_line(line, cfg, entry.level, timestamps.format(entry.time), entry.text);
+        std::fwrite(line.data(), 1, line.size(), stdout);
+    }
+
+    if (reader.corrupt()) {
+        std::fprintf(stderr, "%s: stopped at a malformed entry\n", argv[1]);
+        return 2;
+    }
+}
@@ -0,0 +1,28 @@
+#include <AbyssFramework/Profiler.h>
+#include <cstdio>
+
+// Converts a binary profile (aby::prof::write_binary) to Chrome trace-event JSON,
+// written to <out.json> or stdout. Open the result in chrome://tracing or Perfetto.
+
+int main(int argc, char** argv) {
+    if (argc != 2 && argc != 3) {
+        std::fprintf(stderr, "usage: AbyssFrameworkProfDump <file.abyprof> [out.json]\n");
+        return 1;
+    }
+
+    aby::prof::Capture capture;
+    if (!aby::prof::read_binary(argv[1], capture)) {
+        std::fprintf(stderr, "%s: not a valid binary profile\n", argv[1]);
+        return 2;
+    }
+
+    if (argc == 3) {
+        if (!aby::prof::write_chrome_trace(capture, argv[2])) {
+            std::fprintf(stderr, "cannot write %s\n", argv[2]);
+            return 1;
+        }
+        return 0;
+    }
+    std::string json = aby::prof::to_chrome_trace(capture);
+    std::fwrite(json.data(), 1, json.size(), stdout);
+}
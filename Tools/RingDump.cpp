@@ -0,0 +1,27 @@
+#include <AbyssFramework/sinks/RingSink.h>
+#include <cstdio>
+
+// Prints the records kept by a RingSink flight recorder file, oldest first.
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: AbyssFrameworkRingDump <file>\n");
+        return 1;
+    }
+
+    aby::log::ringlog::Reader reader(argv[1]);
+    if (!reader.is_open()) {
+        std::fprintf(stderr, "%s: not a ring log\n", argv[1]);
+        return 1;
+    }
+
+    std::string line;
+    while (reader.next(line)) {
+        std::fwrite(line.data(), 1, line.size(), stdout);
+    }
+
+    if (reader.corrupt()) {
+        std::fprintf(stderr, "%s: stopped at a malformed record\n", argv[1]);
+        return 2;
+    }
+}
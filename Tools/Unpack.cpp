@@ -0,0 +1,16 @@
+#include <AbyssFramework/Compression.h>
+#include <cstdio>
+
+// Writes the contents of a compressed log segment ("<segment>.lz") to stdout.
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: AbyssFrameworkUnpack <file.lz>\n");
+        return 1;
+    }
+
+    if (!aby::lz::decompress_file(argv[1], stdout)) {
+        std::fprintf(stderr, "%s: not a valid compressed log segment\n", argv[1]);
+        return 2;
+    }
+}